@@ -0,0 +1,164 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#include "Biquad.hpp"
+
+#include <chrono>
+#include <vector>
+
+USE_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static constexpr const double kSampleRate = 48000.0;
+static constexpr const uint32_t kBlockSize = 32;
+static constexpr const uint32_t kNumBlocks = 20000;
+static constexpr const uint32_t kNumStages = 4;
+
+// --------------------------------------------------------------------------------------------------------------------
+// approximation error bounds, as documented in FastMath.hpp
+
+static bool checkFastMath()
+{
+    double errExp2 = 0.0, errLog2 = 0.0, errSin = 0.0, errCos = 0.0;
+
+    for (int i = 0; i <= 1000000; ++i)
+    {
+        const float x = -126.f + 252.f * i / 1000000;
+        errExp2 = std::max(errExp2, std::abs(FastMath::exp2(x) / std::exp2(static_cast<double>(x)) - 1.0));
+    }
+
+    for (int i = 0; i <= 1000000; ++i)
+    {
+        const float x = 0.5f + 1.5f * i / 1000000;
+        errLog2 = std::max(errLog2, std::abs(FastMath::log2(x) - std::log2(static_cast<double>(x))));
+    }
+
+    for (int i = 0; i <= 1000000; ++i)
+    {
+        const float x = FastMath::kPi * i / 1000000;
+        float s, c;
+        FastMath::sinCos(x, s, c);
+        errSin = std::max(errSin, std::abs(s - std::sin(static_cast<double>(x))));
+        errCos = std::max(errCos, std::abs(c - std::cos(static_cast<double>(x))));
+    }
+
+    std::printf("FastMath max error: exp2 %g (rel), log2 %g, sin %g, cos %g\n", errExp2, errLog2, errSin, errCos);
+
+    return errExp2 <= 1.6e-7 && errLog2 <= 2.0e-7 && errSin <= 2.1e-7 && errCos <= 2.1e-7;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// plain per-channel biquads, the way the cascade would be written without lane interleaving
+
+struct ScalarBiquad {
+    BiquadCoefficients c;
+    float s1 = 0.f, s2 = 0.f;
+
+    void process(float* const data, const uint32_t frames) noexcept
+    {
+        for (uint32_t i = 0; i < frames; ++i)
+        {
+            const float in = data[i];
+            const float out = c.b0 * in + s1;
+            s1 = c.b1 * in - c.a1 * out + s2;
+            s2 = c.b2 * in - c.a2 * out;
+            data[i] = out;
+        }
+    }
+};
+
+static BiquadCoefficients designStage(const uint32_t stage, const uint32_t block)
+{
+    // sweep parameters so the cascade has to interpolate coefficients all the time
+    const float mod = 0.5f + 0.5f * std::sin(block * 0.01f);
+
+    switch (stage)
+    {
+    case 0: return BiquadCoefficients::highPass(20.f + 100.f * mod, 0.7071f, kSampleRate);
+    case 1: return BiquadCoefficients::lowShelf(100.f, 6.f * mod, kSampleRate);
+    case 2: return BiquadCoefficients::bell(1000.f + 2000.f * mod, -6.f, 1.f, kSampleRate);
+    default: return BiquadCoefficients::highShelf(10000.f, 3.f * mod, kSampleRate);
+    }
+}
+
+template <uint32_t kChannels>
+static void benchmark()
+{
+    static constexpr const uint32_t kLanes = (kChannels + 3) & ~3u;
+
+    std::vector<float> interleaved(kBlockSize * kLanes);
+    std::vector<float> planar(kBlockSize * kChannels);
+
+    for (uint32_t i = 0; i < interleaved.size(); ++i)
+        interleaved[i] = static_cast<float>(std::rand()) / RAND_MAX - 0.5f;
+    for (uint32_t i = 0; i < planar.size(); ++i)
+        planar[i] = static_cast<float>(std::rand()) / RAND_MAX - 0.5f;
+
+    BiquadCascade<kNumStages, kLanes> cascade;
+    ScalarBiquad scalar[kChannels][kNumStages];
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    for (uint32_t b = 0; b < kNumBlocks; ++b)
+    {
+        for (uint32_t s = 0; s < kNumStages; ++s)
+            cascade.setTarget(s, designStage(s, b));
+
+        cascade.process(interleaved.data(), kBlockSize);
+    }
+
+    const auto t1 = std::chrono::steady_clock::now();
+
+    for (uint32_t b = 0; b < kNumBlocks; ++b)
+    {
+        for (uint32_t s = 0; s < kNumStages; ++s)
+        {
+            const BiquadCoefficients coefs = designStage(s, b);
+
+            for (uint32_t c = 0; c < kChannels; ++c)
+            {
+                scalar[c][s].c = coefs;
+                scalar[c][s].process(planar.data() + c * kBlockSize, kBlockSize);
+            }
+        }
+    }
+
+    const auto t2 = std::chrono::steady_clock::now();
+
+    const double samples = static_cast<double>(kNumBlocks) * kBlockSize * kChannels;
+    const double nsCascade = std::chrono::duration<double, std::nano>(t1 - t0).count() / samples;
+    const double nsScalar = std::chrono::duration<double, std::nano>(t2 - t1).count() / samples;
+
+    // keep results alive
+    volatile float sink = interleaved[0] + planar[0];
+    (void)sink;
+
+    std::printf("%2u channels, %u stages: cascade %.3f ns/sample, scalar %.3f ns/sample (%.2fx)\n",
+                kChannels, kNumStages, nsCascade, nsScalar, nsScalar / nsCascade);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    const bool fastMathOk = checkFastMath();
+
+    benchmark<2>();
+    benchmark<8>();
+    benchmark<16>();
+
+    if (! fastMathOk)
+    {
+        std::fprintf(stderr, "FastMath error bounds exceeded\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
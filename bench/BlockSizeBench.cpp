@@ -0,0 +1,178 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+// DSP throughput of the VST2 binary across host buffer sizes, from 32 to 8192 frames.
+// The plugin runs all stages over internal chunks of bounded size, so large host buffers should not be slower per
+// frame than small ones; a rising cost towards the large sizes means some stage streams the whole host buffer again.
+// Every size processes the same audio with the same settings, best of a few runs is reported.
+
+#include "DistrhoPluginInfo.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <dlfcn.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static constexpr const float kSampleRate = 48000.0f;
+static constexpr const uint32_t kTotalFrames = 1u << 21; // about 44 seconds of audio per run
+static constexpr const uint32_t kNumRuns = 5;
+
+// the parts of the VST2 ABI used here
+struct AEffect;
+typedef intptr_t (*AudioMasterCallback)(AEffect*, int32_t, int32_t, intptr_t, void*, float);
+
+struct AEffect {
+    int32_t magic;
+    intptr_t (*dispatcher)(AEffect*, int32_t, int32_t, intptr_t, void*, float);
+    void (*process)(AEffect*, float**, float**, int32_t);
+    void (*setParameter)(AEffect*, int32_t, float);
+    float (*getParameter)(AEffect*, int32_t);
+    int32_t numPrograms, numParams, numInputs, numOutputs, flags;
+    intptr_t resvd1, resvd2;
+    int32_t initialDelay, realQualities, offQualities;
+    float ioRatio;
+    void* object;
+    void* user;
+    int32_t uniqueID, version;
+    void (*processReplacing)(AEffect*, float**, float**, int32_t);
+};
+
+enum {
+    effOpen = 0,
+    effClose = 1,
+    effSetSampleRate = 10,
+    effSetBlockSize = 11,
+    effMainsChanged = 12,
+    audioMasterVersion = 1,
+};
+
+static intptr_t hostCallback(AEffect*, const int32_t opcode, int32_t, intptr_t, void*, float)
+{
+    return opcode == audioMasterVersion ? 2400 : 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Cost in ns per frame of processing kTotalFrames of @a input in host blocks of @a bufferSize frames.
+ */
+static double measure(AEffect* const effect, const std::vector<float>& input, const uint32_t bufferSize)
+{
+    effect->dispatcher(effect, effSetBlockSize, 0, bufferSize, nullptr, 0.0f);
+    effect->dispatcher(effect, effMainsChanged, 0, 1, nullptr, 0.0f);
+
+    // busy settings, so every stage runs: EQ, gate, compressor, alignment delay and shaped dither
+    effect->setParameter(effect, kParamHighPassFreq, 0.1f);
+    effect->setParameter(effect, kParamLowShelfGain, 0.6f);
+    effect->setParameter(effect, kParamBellGain, 0.75f);
+    effect->setParameter(effect, kParamHighShelfGain, 0.4f);
+    effect->setParameter(effect, kParamGateThreshold, 0.3f);
+    effect->setParameter(effect, kParamCompThreshold, 0.4f);
+    effect->setParameter(effect, kParamCompRatio, 0.3f);
+    effect->setParameter(effect, kParamAlignment, 1.0f);
+    effect->setParameter(effect, kParamDelayLeft, 0.02f);
+    effect->setParameter(effect, kParamDither, 1.0f / 3.0f);
+    effect->setParameter(effect, kParamDitherShaping, 1.0f);
+
+    std::vector<float> outLeft(bufferSize), outRight(bufferSize);
+    float* outputs[2] = { outLeft.data(), outRight.data() };
+    double best = 0.0;
+
+    for (uint32_t run = 0; run < kNumRuns; ++run)
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        for (uint32_t offset = 0; offset + bufferSize <= kTotalFrames; offset += bufferSize)
+        {
+            // the same audio whatever the block size, read in place from one long planar signal
+            float* inputs[2] = {
+                const_cast<float*>(input.data()) + offset,
+                const_cast<float*>(input.data()) + kTotalFrames + offset,
+            };
+
+            effect->processReplacing(effect, inputs, outputs, static_cast<int32_t>(bufferSize));
+        }
+
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = run == 0 ? ns : std::min(best, ns);
+    }
+
+    effect->dispatcher(effect, effMainsChanged, 0, 0, nullptr, 0.0f);
+
+    return best / kTotalFrames;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* path = nullptr;
+
+   #ifdef BLOCK_SIZE_BENCH_VST2
+    path = BLOCK_SIZE_BENCH_VST2;
+   #endif
+
+    if (argc > 1)
+        path = argv[1];
+
+    if (path == nullptr)
+    {
+        std::fprintf(stderr, "usage: %s plugin-vst2.so\n", argv[0]);
+        return 2;
+    }
+
+    void* const lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+
+    if (lib == nullptr)
+    {
+        std::fprintf(stderr, "failed to load %s: %s\n", path, dlerror());
+        return 1;
+    }
+
+    typedef AEffect* (*entry_t)(AudioMasterCallback);
+    const entry_t entry = reinterpret_cast<entry_t>(dlsym(lib, "VSTPluginMain"));
+    AEffect* const effect = entry != nullptr ? entry(hostCallback) : nullptr;
+
+    if (effect == nullptr || effect->processReplacing == nullptr)
+    {
+        std::fprintf(stderr, "%s is not a usable VST2 plugin\n", path);
+        dlclose(lib);
+        return 1;
+    }
+
+    effect->dispatcher(effect, effOpen, 0, 0, nullptr, 0.0f);
+    effect->dispatcher(effect, effSetSampleRate, 0, 0, nullptr, kSampleRate);
+
+    // program material: two detuned chords over a noise floor, left then right channel
+    std::vector<float> input(kTotalFrames * 2);
+    uint32_t noise = 1;
+
+    for (uint32_t i = 0; i < kTotalFrames; ++i)
+    {
+        const float t = static_cast<float>(i) / kSampleRate;
+        noise = noise * 1664525u + 1013904223u;
+        const float n = static_cast<float>(noise >> 8) / 16777216.0f - 0.5f;
+
+        input[i] = 0.3f * (std::sin(6.2831853f * 220.0f * t) + 0.5f * std::sin(6.2831853f * 277.2f * t)) + 0.01f * n;
+        input[kTotalFrames + i] = 0.3f * std::sin(6.2831853f * 329.6f * t) - 0.01f * n;
+    }
+
+    std::printf("buffer size    ns/frame\n");
+
+    for (uint32_t bufferSize = 32; bufferSize <= 8192; bufferSize *= 2)
+        std::printf("%11u  %10.2f\n", bufferSize, measure(effect, input, bufferSize));
+
+    effect->dispatcher(effect, effClose, 0, 0, nullptr, 0.0f);
+    dlclose(lib);
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,106 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+// Dithered output must be bit-reproducible, so offline renders of the same session give the same file.
+// Renders a fixed input twice through the same Dither, each time after reset(kDitherSeed) as the plugin does on
+// activate, for every word length and noise shaping the plugin offers, in blocks like the plugin does, and compares
+// the bits. Another seed must give different bits, or the seed would not be what makes the output reproducible.
+// Returns non-zero on failure.
+
+#include "Dither.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+USE_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static constexpr const uint32_t kLanes = 4;
+static constexpr const uint32_t kBlockSize = 256;
+static constexpr const uint32_t kNumBlocks = 200;
+static constexpr const uint32_t kBits[] = { 16, 20, 24 };
+
+typedef Dither<kLanes> TestDither;
+
+/**
+   Interleaved output of @a dither for a fixed stereo signal at @a bits with @a shaping, restarted from @a seed.
+ */
+static std::vector<float> render(TestDither& dither, const uint32_t bits, const uint32_t shaping, const uint32_t seed)
+{
+    dither.setup(bits, shaping);
+    dither.reset(seed);
+
+    std::vector<float> output(kBlockSize * kNumBlocks * kLanes, 0.0f);
+    std::vector<float> noise(kBlockSize * kLanes);
+
+    for (uint32_t b = 0; b < kNumBlocks; ++b)
+    {
+        float* const block = output.data() + b * kBlockSize * kLanes;
+
+        // a quiet tone on the left, a slower one on the right, padding lanes stay silent as in the plugin
+        for (uint32_t i = 0; i < kBlockSize; ++i)
+        {
+            const float t = static_cast<float>(b * kBlockSize + i) / 48000.0f;
+            block[i * kLanes] = 0.001f * std::sin(6.2831853f * 1000.0f * t);
+            block[i * kLanes + 1] = 0.0003f * std::sin(6.2831853f * 97.0f * t);
+        }
+
+        dither.prepare(noise.data(), kBlockSize);
+
+        for (uint32_t i = 0; i < kBlockSize; ++i)
+            dither.processFrame(block + i * kLanes, noise.data() + i * kLanes);
+    }
+
+    return output;
+}
+
+static bool sameBits(const std::vector<float>& a, const std::vector<float>& b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    uint32_t failures = 0;
+
+    for (const uint32_t bits : kBits)
+    {
+        for (uint32_t shaping = 0; shaping < TestDither::kShapingCount; ++shaping)
+        {
+            TestDither dither;
+            const std::vector<float> first = render(dither, bits, shaping, kDitherSeed);
+            const std::vector<float> second = render(dither, bits, shaping, kDitherSeed);
+            const std::vector<float> other = render(dither, bits, shaping, kDitherSeed + 1);
+
+            if (! sameBits(first, second))
+            {
+                std::fprintf(stderr, "FAIL: %u bit, shaping %u: renders with the same seed differ\n", bits, shaping);
+                ++failures;
+            }
+
+            if (sameBits(first, other))
+            {
+                std::fprintf(stderr, "FAIL: %u bit, shaping %u: renders do not depend on the seed\n", bits, shaping);
+                ++failures;
+            }
+        }
+    }
+
+    std::printf("%u word lengths, %u noise shapings, %u failures\n",
+                static_cast<uint32_t>(sizeof(kBits) / sizeof(kBits[0])),
+                static_cast<uint32_t>(TestDither::kShapingCount),
+                failures);
+
+    return failures == 0 ? 0 : 1;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
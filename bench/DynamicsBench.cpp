@@ -0,0 +1,151 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#include "Dynamics.hpp"
+
+#include <chrono>
+#include <vector>
+
+USE_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static constexpr const double kSampleRate = 48000.0;
+static constexpr const uint32_t kBlockSize = 256;
+static constexpr const uint32_t kNumBlocks = 4000;
+
+// --------------------------------------------------------------------------------------------------------------------
+// straightforward per-channel compressor using std::log10 and std::pow, for reference
+
+struct ReferenceCompressor {
+    float env = 0.f, reduction = 0.f;
+    float decay, attack, release;
+
+    ReferenceCompressor()
+        : decay(dynamicsCoefficient(10.f, kSampleRate)),
+          attack(dynamicsCoefficient(5.f, kSampleRate)),
+          release(dynamicsCoefficient(100.f, kSampleRate)) {}
+
+    void process(float* const data, const uint32_t frames) noexcept
+    {
+        for (uint32_t i = 0; i < frames; ++i)
+        {
+            env = std::max(std::abs(data[i]), env * decay);
+
+            const float levelDB = 20.f * std::log10(std::max(env, 1e-6f));
+            const float target = levelDB > -20.f ? (levelDB + 20.f) * (1.f / 4.f - 1.f) : 0.f;
+            reduction = target + (reduction - target) * (target < reduction ? attack : release);
+
+            data[i] *= std::pow(10.f, reduction * 0.05f);
+        }
+    }
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+template <uint32_t kChannels, typename Process>
+static double measure(const float amplitude, const bool dynamic, Process process)
+{
+    static constexpr const uint32_t kLanes = (kChannels + 3) & ~3u;
+    static constexpr const uint32_t kSignalBlocks = 100;
+
+    // alternate loud and quiet passages so the dynamics keep moving, or keep a steady level
+    std::vector<float> signal(kSignalBlocks * kBlockSize * kLanes);
+
+    for (uint32_t b = 0; b < kSignalBlocks; ++b)
+    {
+        const float a = dynamic && b >= kSignalBlocks / 2 ? amplitude * 0.01f : amplitude;
+
+        for (uint32_t i = 0; i < kBlockSize; ++i)
+            for (uint32_t l = 0; l < kLanes; ++l)
+                signal[(b * kBlockSize + i) * kLanes + l] = l < kChannels
+                                                          ? a * std::sin(0.05f * (b * kBlockSize + i) + l)
+                                                          : 0.f;
+    }
+
+    std::vector<float> data(kBlockSize * kLanes);
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    for (uint32_t b = 0; b < kNumBlocks; ++b)
+    {
+        std::memcpy(data.data(), signal.data() + (b % kSignalBlocks) * kBlockSize * kLanes,
+                    sizeof(float) * kBlockSize * kLanes);
+        process(data.data());
+    }
+
+    const auto t1 = std::chrono::steady_clock::now();
+
+    volatile float sink = data[0];
+    (void)sink;
+
+    const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    return ns / (static_cast<double>(kNumBlocks) * kBlockSize * kChannels);
+}
+
+template <uint32_t kChannels>
+static void benchmark()
+{
+    static constexpr const uint32_t kLanes = (kChannels + 3) & ~3u;
+
+    NoiseGate<kChannels, kLanes> gate;
+    gate.setup(-40.f, 20.f, 60.f, 3.f, 20.f, 1.f, 100.f, true, kSampleRate);
+
+    Compressor<kChannels, kLanes> compressor;
+    compressor.setup(-20.f, 4.f, 6.f, 5.f, 100.f, 0.f, false, true, kSampleRate);
+
+    ReferenceCompressor reference[kChannels];
+
+    const double gateActive = measure<kChannels>(0.5f, true, [&](float* const data) {
+        gate.process(data, kBlockSize);
+    });
+
+    gate.reset();
+    const double gateIdle = measure<kChannels>(0.5f, false, [&](float* const data) {
+        gate.process(data, kBlockSize);
+    });
+
+    const double compActive = measure<kChannels>(1.f, true, [&](float* const data) {
+        compressor.process(data, kBlockSize);
+    });
+
+    compressor.reset();
+    const double compIdle = measure<kChannels>(0.01f, false, [&](float* const data) {
+        compressor.process(data, kBlockSize);
+    });
+
+    const double compRef = measure<kChannels>(1.f, true, [&](float* const data) {
+        // the reference works on planar data, deinterleaving is not counted against it
+        float planar[kBlockSize];
+
+        for (uint32_t c = 0; c < kChannels; ++c)
+        {
+            for (uint32_t i = 0; i < kBlockSize; ++i)
+                planar[i] = data[i * kLanes + c];
+
+            reference[c].process(planar, kBlockSize);
+
+            for (uint32_t i = 0; i < kBlockSize; ++i)
+                data[i * kLanes + c] = planar[i];
+        }
+    });
+
+    std::printf("%2u channels: gate %.3f ns/sample (idle %.3f), compressor %.3f ns/sample (idle %.3f), "
+                "std::log10/std::pow compressor %.3f ns/sample\n",
+                kChannels, gateActive, gateIdle, compActive, compIdle, compRef);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    benchmark<2>();
+    benchmark<16>();
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
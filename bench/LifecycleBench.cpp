@@ -0,0 +1,284 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+// What loading a large session costs: creates 1000 instances of the VST2 binary and takes them all through their
+// lifecycle one phase at a time (create, activate, sample rate change, a few blocks of audio, deactivate, destroy),
+// reporting the time and resident memory each phase adds, in total and per instance.
+// Instances are created through the plugin entry point, which is where DPF calls createPlugin(); the DSP class
+// itself cannot live outside of a DPF wrapper.
+// With --ui and a running X server (Xvfb is fine) every instance also opens, idles and closes its editor.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static constexpr const uint32_t kDefaultInstances = 1000;
+static constexpr const float kSampleRate = 48000.0f;
+static constexpr const float kChangedSampleRate = 96000.0f;
+static constexpr const uint32_t kBufferSize = 512;
+static constexpr const uint32_t kRunBlocks = 8;
+
+// the parts of the VST2 ABI used here
+struct AEffect;
+typedef intptr_t (*AudioMasterCallback)(AEffect*, int32_t, int32_t, intptr_t, void*, float);
+
+struct AEffect {
+    int32_t magic;
+    intptr_t (*dispatcher)(AEffect*, int32_t, int32_t, intptr_t, void*, float);
+    void (*process)(AEffect*, float**, float**, int32_t);
+    void (*setParameter)(AEffect*, int32_t, float);
+    float (*getParameter)(AEffect*, int32_t);
+    int32_t numPrograms, numParams, numInputs, numOutputs, flags;
+    intptr_t resvd1, resvd2;
+    int32_t initialDelay, realQualities, offQualities;
+    float ioRatio;
+    void* object;
+    void* user;
+    int32_t uniqueID, version;
+    void (*processReplacing)(AEffect*, float**, float**, int32_t);
+};
+
+enum {
+    effOpen = 0,
+    effClose = 1,
+    effSetSampleRate = 10,
+    effSetBlockSize = 11,
+    effMainsChanged = 12,
+    effEditOpen = 14,
+    effEditClose = 15,
+    effEditIdle = 19,
+    audioMasterVersion = 1,
+};
+
+static intptr_t hostCallback(AEffect*, const int32_t opcode, int32_t, intptr_t, void*, float)
+{
+    return opcode == audioMasterVersion ? 2400 : 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+   Resident memory of this process in bytes, 0 where it cannot be read.
+ */
+static int64_t getResidentBytes()
+{
+   #ifdef __linux__
+    if (FILE* const f = std::fopen("/proc/self/statm", "r"))
+    {
+        long long total = 0, resident = 0;
+        const int read = std::fscanf(f, "%lld %lld", &total, &resident);
+        std::fclose(f);
+
+        if (read == 2)
+            return static_cast<int64_t>(resident) * sysconf(_SC_PAGESIZE);
+    }
+   #endif
+
+    return 0;
+}
+
+/**
+   Times one lifecycle phase over all instances and prints a line for it.
+ */
+class Phase
+{
+public:
+    explicit Phase(const char* const name, const uint32_t count)
+        : fName(name),
+          fCount(count),
+          fStart(Clock::now()),
+          fResident(getResidentBytes()) {}
+
+    ~Phase()
+    {
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - fStart).count();
+        const double kb = static_cast<double>(getResidentBytes() - fResident) / 1024.0;
+
+        std::printf("%-18s %10.2f %12.2f %12.0f %12.1f\n",
+                    fName, ms, ms * 1000.0 / fCount, kb, kb / fCount);
+    }
+
+    static void printHeader()
+    {
+        std::printf("%-18s %10s %12s %12s %12s\n", "phase", "total ms", "us/instance", "RSS KB", "KB/instance");
+    }
+
+private:
+    const char* const fName;
+    const uint32_t fCount;
+    const Clock::time_point fStart;
+    const int64_t fResident;
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    const char* path = nullptr;
+    uint32_t count = kDefaultInstances;
+    bool withUI = false;
+
+   #ifdef LIFECYCLE_BENCH_VST2
+    path = LIFECYCLE_BENCH_VST2;
+   #endif
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--ui") == 0)
+            withUI = true;
+        else if (std::strcmp(argv[i], "--instances") == 0 && i + 1 < argc)
+            count = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        else
+            path = argv[i];
+    }
+
+    if (path == nullptr)
+    {
+        std::fprintf(stderr, "usage: %s [--ui] [--instances count] plugin-vst2.so\n", argv[0]);
+        return 2;
+    }
+
+    if (withUI && std::getenv("DISPLAY") == nullptr)
+    {
+        std::fprintf(stderr, "no DISPLAY set, running without the editors\n");
+        withUI = false;
+    }
+
+    void* const lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+
+    if (lib == nullptr)
+    {
+        std::fprintf(stderr, "failed to load %s: %s\n", path, dlerror());
+        return 1;
+    }
+
+    typedef AEffect* (*entry_t)(AudioMasterCallback);
+    const entry_t entry = reinterpret_cast<entry_t>(dlsym(lib, "VSTPluginMain"));
+
+    if (entry == nullptr)
+    {
+        std::fprintf(stderr, "%s is not a VST2 plugin\n", path);
+        dlclose(lib);
+        return 1;
+    }
+
+    // a quiet tone, so the blocks are really processed and not skipped as silence
+    std::vector<float> left(kBufferSize), right(kBufferSize), outLeft(kBufferSize), outRight(kBufferSize);
+    float* inputs[2] = { left.data(), right.data() };
+    float* outputs[2] = { outLeft.data(), outRight.data() };
+
+    for (uint32_t i = 0; i < kBufferSize; ++i)
+        left[i] = right[i] = 0.1f * std::sin(6.2831853f * 440.0f * static_cast<float>(i) / kSampleRate);
+
+    std::vector<AEffect*> effects(count, nullptr);
+
+    std::printf("%u instances of %s\n", count, path);
+    Phase::printHeader();
+
+    {
+        const Phase phase("create", count);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            AEffect* const effect = entry(hostCallback);
+
+            if (effect == nullptr || effect->processReplacing == nullptr)
+            {
+                std::fprintf(stderr, "instance %u could not be created\n", i);
+                return 1;
+            }
+
+            effect->dispatcher(effect, effOpen, 0, 0, nullptr, 0.0f);
+            effects[i] = effect;
+        }
+    }
+
+    {
+        const Phase phase("activate", count);
+
+        for (AEffect* const effect : effects)
+        {
+            effect->dispatcher(effect, effSetSampleRate, 0, 0, nullptr, kSampleRate);
+            effect->dispatcher(effect, effSetBlockSize, 0, kBufferSize, nullptr, 0.0f);
+            effect->dispatcher(effect, effMainsChanged, 0, 1, nullptr, 0.0f);
+        }
+    }
+
+    {
+        // what hosts do when the session rate changes, reaching sampleRateChanged() and a new activate()
+        const Phase phase("sample rate change", count);
+
+        for (AEffect* const effect : effects)
+        {
+            effect->dispatcher(effect, effMainsChanged, 0, 0, nullptr, 0.0f);
+            effect->dispatcher(effect, effSetSampleRate, 0, 0, nullptr, kChangedSampleRate);
+            effect->dispatcher(effect, effMainsChanged, 0, 1, nullptr, 0.0f);
+        }
+    }
+
+    {
+        const Phase phase("run", count);
+
+        for (AEffect* const effect : effects)
+            for (uint32_t b = 0; b < kRunBlocks; ++b)
+                effect->processReplacing(effect, inputs, outputs, kBufferSize);
+    }
+
+    if (withUI)
+    {
+        {
+            const Phase phase("editor open", count);
+
+            for (AEffect* const effect : effects)
+            {
+                effect->dispatcher(effect, effEditOpen, 0, 0, nullptr, 0.0f);
+                effect->dispatcher(effect, effEditIdle, 0, 0, nullptr, 0.0f);
+            }
+        }
+
+        {
+            const Phase phase("editor close", count);
+
+            for (AEffect* const effect : effects)
+                effect->dispatcher(effect, effEditClose, 0, 0, nullptr, 0.0f);
+        }
+    }
+
+    {
+        const Phase phase("deactivate", count);
+
+        for (AEffect* const effect : effects)
+            effect->dispatcher(effect, effMainsChanged, 0, 0, nullptr, 0.0f);
+    }
+
+    {
+        const Phase phase("destroy", count);
+
+        for (AEffect*& effect : effects)
+        {
+            effect->dispatcher(effect, effClose, 0, 0, nullptr, 0.0f);
+            effect = nullptr;
+        }
+    }
+
+    dlclose(lib);
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
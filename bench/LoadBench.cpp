@@ -0,0 +1,393 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+// Measures what a host pays to scan this plugin: dlopen, instantiate, destroy and dlclose, per plugin format.
+// Only the minimal parts of each plugin ABI are declared here, so no plugin SDK is needed to build this.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <dlfcn.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static constexpr const uint32_t kNumRounds = 50;
+static constexpr const double kSampleRate = 48000.0;
+static constexpr const uint32_t kBufferSize = 512;
+
+typedef std::chrono::steady_clock Clock;
+
+struct Timings {
+    double load = 0.0, instantiate = 0.0, unload = 0.0;
+};
+
+static double elapsedUs(const Clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+static std::string getDirectory(const char* const path)
+{
+    const std::string s(path);
+    const std::size_t sep = s.rfind('/');
+    return sep != std::string::npos ? s.substr(0, sep + 1) : std::string("./");
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// LV2, needs the URID map and options features
+
+struct LV2_Feature { const char* URI; void* data; };
+struct LV2_URID_Map { void* handle; uint32_t (*map)(void* handle, const char* uri); };
+struct LV2_Options_Option { uint32_t context; uint32_t subject; uint32_t key; uint32_t size; uint32_t type; const void* value; };
+struct LV2_Descriptor {
+    const char* URI;
+    void* (*instantiate)(const LV2_Descriptor*, double, const char*, const LV2_Feature* const*);
+    void (*connect_port)(void*, uint32_t, void*);
+    void (*activate)(void*);
+    void (*run)(void*, uint32_t);
+    void (*deactivate)(void*);
+    void (*cleanup)(void*);
+    const void* (*extension_data)(const char*);
+};
+
+static std::string sURIs[256];
+static uint32_t sNumURIs = 0;
+
+static uint32_t lv2Map(void*, const char* const uri)
+{
+    for (uint32_t i = 0; i < sNumURIs; ++i)
+        if (sURIs[i] == uri)
+            return i + 1;
+
+    if (sNumURIs == 256)
+        return 0;
+
+    sURIs[sNumURIs] = uri;
+    return ++sNumURIs;
+}
+
+static bool lv2Instance(void* const lib, const char* const path)
+{
+    typedef const LV2_Descriptor* (*lv2_descriptor_t)(uint32_t);
+    const lv2_descriptor_t entry = reinterpret_cast<lv2_descriptor_t>(dlsym(lib, "lv2_descriptor"));
+    const LV2_Descriptor* const descriptor = entry != nullptr ? entry(0) : nullptr;
+
+    if (descriptor == nullptr)
+        return false;
+
+    LV2_URID_Map map = { nullptr, lv2Map };
+    const int32_t bufferSize = kBufferSize;
+    const float sampleRate = kSampleRate;
+    const LV2_Options_Option options[] = {
+        { 0, 0, lv2Map(nullptr, "http://lv2plug.in/ns/ext/buf-size#maxBlockLength"), sizeof(int32_t),
+          lv2Map(nullptr, "http://lv2plug.in/ns/ext/atom#Int"), &bufferSize },
+        { 0, 0, lv2Map(nullptr, "http://lv2plug.in/ns/ext/buf-size#nominalBlockLength"), sizeof(int32_t),
+          lv2Map(nullptr, "http://lv2plug.in/ns/ext/atom#Int"), &bufferSize },
+        { 0, 0, lv2Map(nullptr, "http://lv2plug.in/ns/ext/parameters#sampleRate"), sizeof(float),
+          lv2Map(nullptr, "http://lv2plug.in/ns/ext/atom#Float"), &sampleRate },
+        { 0, 0, 0, 0, 0, nullptr },
+    };
+    LV2_Feature mapFeature = { "http://lv2plug.in/ns/ext/urid#map", &map };
+    LV2_Feature optionsFeature = { "http://lv2plug.in/ns/ext/options#options", const_cast<LV2_Options_Option*>(options) };
+    const LV2_Feature* const features[] = { &mapFeature, &optionsFeature, nullptr };
+
+    const std::string bundle = getDirectory(path);
+
+    void* const handle = descriptor->instantiate(descriptor, kSampleRate, bundle.c_str(), features);
+
+    if (handle == nullptr)
+        return false;
+
+    descriptor->cleanup(handle);
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// VST2
+
+struct AEffect {
+    int32_t magic;
+    intptr_t (*dispatcher)(AEffect*, int32_t, int32_t, intptr_t, void*, float);
+};
+
+static intptr_t vst2HostCallback(AEffect*, const int32_t opcode, int32_t, intptr_t, void*, float)
+{
+    // audioMasterVersion
+    return opcode == 1 ? 2400 : 0;
+}
+
+static bool vst2Instance(void* const lib, const char*)
+{
+    typedef intptr_t (*callback_t)(AEffect*, int32_t, int32_t, intptr_t, void*, float);
+    typedef AEffect* (*entry_t)(callback_t);
+
+    entry_t entry = reinterpret_cast<entry_t>(dlsym(lib, "VSTPluginMain"));
+
+    if (entry == nullptr)
+        entry = reinterpret_cast<entry_t>(dlsym(lib, "main"));
+    if (entry == nullptr)
+        return false;
+
+    AEffect* const effect = entry(vst2HostCallback);
+
+    if (effect == nullptr)
+        return false;
+
+    effect->dispatcher(effect, 0 /* effOpen */, 0, 0, nullptr, 0.0f);
+    effect->dispatcher(effect, 1 /* effClose */, 0, 0, nullptr, 0.0f);
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// CLAP
+
+struct clap_version_t { uint32_t major, minor, revision; };
+struct clap_host_t {
+    clap_version_t clap_version;
+    void* host_data;
+    const char *name, *vendor, *url, *version;
+    const void* (*get_extension)(const clap_host_t*, const char*);
+    void (*request_restart)(const clap_host_t*);
+    void (*request_process)(const clap_host_t*);
+    void (*request_callback)(const clap_host_t*);
+};
+struct clap_plugin_descriptor_t { clap_version_t clap_version; const char* id; };
+struct clap_plugin_t {
+    const clap_plugin_descriptor_t* desc;
+    void* plugin_data;
+    bool (*init)(const clap_plugin_t*);
+    void (*destroy)(const clap_plugin_t*);
+};
+struct clap_plugin_factory_t {
+    uint32_t (*get_plugin_count)(const clap_plugin_factory_t*);
+    const clap_plugin_descriptor_t* (*get_plugin_descriptor)(const clap_plugin_factory_t*, uint32_t);
+    const clap_plugin_t* (*create_plugin)(const clap_plugin_factory_t*, const clap_host_t*, const char*);
+};
+struct clap_plugin_entry_t {
+    clap_version_t clap_version;
+    bool (*init)(const char*);
+    void (*deinit)();
+    const void* (*get_factory)(const char*);
+};
+
+static const void* clapGetExtension(const clap_host_t*, const char*) { return nullptr; }
+static void clapRequest(const clap_host_t*) {}
+
+static bool clapInstance(void* const lib, const char* const path)
+{
+    const clap_plugin_entry_t* const entry = static_cast<const clap_plugin_entry_t*>(dlsym(lib, "clap_entry"));
+
+    if (entry == nullptr || ! entry->init(path))
+        return false;
+
+    bool ok = false;
+    const clap_plugin_factory_t* const factory
+        = static_cast<const clap_plugin_factory_t*>(entry->get_factory("clap.plugin-factory"));
+
+    if (factory != nullptr && factory->get_plugin_count(factory) != 0)
+    {
+        const clap_host_t host = {
+            { 1, 0, 0 }, nullptr, "load-bench", "", "", "1.0",
+            clapGetExtension, clapRequest, clapRequest, clapRequest
+        };
+        const clap_plugin_descriptor_t* const descriptor = factory->get_plugin_descriptor(factory, 0);
+
+        if (const clap_plugin_t* const plugin = factory->create_plugin(factory, &host, descriptor->id))
+        {
+            ok = plugin->init(plugin);
+            plugin->destroy(plugin);
+        }
+    }
+
+    entry->deinit();
+    return ok;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// VST3, through the raw COM-style vtables
+
+struct PClassInfo { uint8_t cid[16]; int32_t cardinality; char category[32]; char name[64]; };
+
+struct FUnknownVtbl {
+    int32_t (*queryInterface)(void*, const uint8_t*, void**);
+    uint32_t (*addRef)(void*);
+    uint32_t (*release)(void*);
+};
+struct IPluginFactoryVtbl {
+    FUnknownVtbl unknown;
+    int32_t (*getFactoryInfo)(void*, void*);
+    int32_t (*countClasses)(void*);
+    int32_t (*getClassInfo)(void*, int32_t, PClassInfo*);
+    int32_t (*createInstance)(void*, const uint8_t*, const uint8_t*, void**);
+};
+struct IPluginBaseVtbl {
+    FUnknownVtbl unknown;
+    int32_t (*initialize)(void*, void*);
+    int32_t (*terminate)(void*);
+};
+
+// IComponent interface id, in the non-COM byte order used on Linux and macOS
+static const uint8_t kIComponentIID[16] = {
+    0xE8, 0x31, 0xFF, 0x31, 0xF2, 0xD5, 0x43, 0x01, 0x92, 0x8E, 0xBB, 0xEE, 0x25, 0x69, 0x78, 0x02
+};
+
+static bool vst3Instance(void* const lib, const char*)
+{
+    typedef void* (*factory_t)();
+    const factory_t getFactory = reinterpret_cast<factory_t>(dlsym(lib, "GetPluginFactory"));
+
+    if (getFactory == nullptr)
+        return false;
+
+    void* const factory = getFactory();
+
+    if (factory == nullptr)
+        return false;
+
+    const IPluginFactoryVtbl* const factoryVtbl = *static_cast<IPluginFactoryVtbl**>(factory);
+    bool ok = false;
+
+    for (int32_t i = 0, count = factoryVtbl->countClasses(factory); i < count && ! ok; ++i)
+    {
+        PClassInfo info;
+        if (factoryVtbl->getClassInfo(factory, i, &info) != 0)
+            continue;
+        if (std::strcmp(info.category, "Audio Module Class") != 0)
+            continue;
+
+        void* component = nullptr;
+        if (factoryVtbl->createInstance(factory, info.cid, kIComponentIID, &component) != 0 || component == nullptr)
+            continue;
+
+        const IPluginBaseVtbl* const componentVtbl = *static_cast<IPluginBaseVtbl**>(component);
+        ok = componentVtbl->initialize(component, nullptr) == 0;
+        componentVtbl->terminate(component);
+        componentVtbl->unknown.release(component);
+    }
+
+    factoryVtbl->unknown.release(factory);
+    return ok;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static bool measure(const char* const format, const char* const path, bool (*instance)(void*, const char*))
+{
+    Timings total, first;
+
+    for (uint32_t r = 0; r < kNumRounds; ++r)
+    {
+        Timings t;
+
+        Clock::time_point start = Clock::now();
+        void* const lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+        t.load = elapsedUs(start);
+
+        if (lib == nullptr)
+        {
+            std::fprintf(stderr, "%s: failed to load %s: %s\n", format, path, dlerror());
+            return false;
+        }
+
+        // VST3 modules on Linux must be entered before use
+        typedef bool (*module_entry_t)(void*);
+        typedef bool (*module_exit_t)();
+        const module_entry_t moduleEntry = reinterpret_cast<module_entry_t>(dlsym(lib, "ModuleEntry"));
+        const module_exit_t moduleExit = reinterpret_cast<module_exit_t>(dlsym(lib, "ModuleExit"));
+
+        if (moduleEntry != nullptr)
+            moduleEntry(lib);
+
+        // instantiate and destroy are measured together, as the ABIs do not split them the same way
+        start = Clock::now();
+        const bool ok = instance(lib, path);
+        t.instantiate = elapsedUs(start);
+
+        if (moduleExit != nullptr)
+            moduleExit();
+
+        start = Clock::now();
+        dlclose(lib);
+        t.unload = elapsedUs(start);
+
+        if (! ok)
+        {
+            std::fprintf(stderr, "%s: failed to instantiate %s\n", format, path);
+            return false;
+        }
+
+        if (r == 0)
+        {
+            first = t;
+        }
+        else
+        {
+            total.load += t.load;
+            total.instantiate += t.instantiate;
+            total.unload += t.unload;
+        }
+    }
+
+    const double n = kNumRounds - 1;
+    std::printf("%-5s first: load %8.1f us, instance %8.1f us, unload %7.1f us | "
+                "warm: load %8.1f us, instance %8.1f us, unload %7.1f us\n",
+                format, first.load, first.instantiate, first.unload,
+                total.load / n, total.instantiate / n, total.unload / n);
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    struct Format {
+        const char* name;
+        const char* path;
+        bool (*instance)(void*, const char*);
+    } formats[] = {
+        { "clap", nullptr, clapInstance },
+        { "lv2", nullptr, lv2Instance },
+        { "vst2", nullptr, vst2Instance },
+        { "vst3", nullptr, vst3Instance },
+    };
+
+   #ifdef LOAD_BENCH_CLAP
+    formats[0].path = LOAD_BENCH_CLAP;
+   #endif
+   #ifdef LOAD_BENCH_LV2
+    formats[1].path = LOAD_BENCH_LV2;
+   #endif
+   #ifdef LOAD_BENCH_VST2
+    formats[2].path = LOAD_BENCH_VST2;
+   #endif
+   #ifdef LOAD_BENCH_VST3
+    formats[3].path = LOAD_BENCH_VST3;
+   #endif
+
+    // paths can be overridden as format=path arguments
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* const sep = std::strchr(argv[i], '=');
+
+        if (sep == nullptr)
+            continue;
+
+        for (Format& format : formats)
+            if (std::strlen(format.name) == static_cast<std::size_t>(sep - argv[i])
+                && std::strncmp(argv[i], format.name, sep - argv[i]) == 0)
+                format.path = sep + 1;
+    }
+
+    bool ok = true;
+
+    for (const Format& format : formats)
+        if (format.path != nullptr)
+            ok = measure(format.name, format.path, format.instance) && ok;
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+// Stress test of the parameter handoff between host threads and the audio thread, see src/ParameterMailbox.hpp.
+// Several threads post input parameter values and read output values while another one collects and publishes them
+// block by block, the way the plugin does. Built with ThreadSanitizer where the compiler has it, so any data race
+// is reported on top of the checks below. Returns non-zero on failure.
+
+#include "DistrhoPluginInfo.h"
+#include "ParameterMailbox.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+USE_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static constexpr const uint32_t kWriters = 3;          // host automation, editor and remote control
+static constexpr const uint32_t kPostsPerWriter = 500000;
+
+static constexpr const uint32_t kOutputs[] = {
+    kParamGateReduction,
+    kParamCompReduction,
+    kParamCorrelation,
+    kParamBalance,
+    kParamMeterLeft,
+    kParamMeterRight,
+};
+
+static bool isOutput(const uint32_t index) noexcept
+{
+    for (const uint32_t output : kOutputs)
+        if (index == output)
+            return true;
+
+    return false;
+}
+
+// posted values tell which writer sent them and in what order, all exact in a float
+static float encode(const uint32_t writer, const uint32_t sequence) noexcept
+{
+    return static_cast<float>(sequence * kWriters + writer);
+}
+
+static void decode(const float value, uint32_t& writer, uint32_t& sequence) noexcept
+{
+    const uint32_t code = static_cast<uint32_t>(value);
+    writer = code % kWriters;
+    sequence = code / kWriters;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+struct Stress {
+    ParameterMailbox<kParamCount> mailbox;
+    std::atomic<uint32_t> writersDone { 0 };
+    std::atomic<uint32_t> failures { 0 };
+
+    // audio thread only, and the main thread once it is joined
+    float applied[kParamCount] = {};
+    bool delivered[kParamCount] = {};
+    int64_t lastSequence[kParamCount][kWriters];
+    uint64_t blocks = 0, changes = 0;
+
+    // written by each writer before it finishes, read once all are joined
+    bool posted[kWriters][kParamCount] = {};
+
+    Stress()
+    {
+        for (uint32_t i = 0; i < kParamCount; ++i)
+        {
+            mailbox.init(i, 0.0f);
+
+            for (uint32_t w = 0; w < kWriters; ++w)
+                lastSequence[i][w] = -1;
+        }
+    }
+
+    void fail(const char* const message, const uint32_t index)
+    {
+        if (failures.fetch_add(1, std::memory_order_relaxed) < 10)
+            std::fprintf(stderr, "FAIL: %s, parameter %u\n", message, index);
+    }
+
+    void write(const uint32_t writer)
+    {
+        uint32_t random = 0x9e3779b9u * (writer + 1);
+        float lastOutput[kParamCount] = {};
+
+        for (uint32_t sequence = 0; sequence < kPostsPerWriter; ++sequence)
+        {
+            random = random * 1664525u + 1013904223u;
+            const uint32_t index = (random >> 8) % kParamCount;
+
+            if (isOutput(index))
+            {
+                // outputs carry the block count, which never goes back
+                const float value = mailbox.read(index);
+
+                if (value < lastOutput[index])
+                    fail("output value went back", index);
+
+                lastOutput[index] = value;
+                continue;
+            }
+
+            mailbox.post(index, encode(writer, sequence));
+            posted[writer][index] = true;
+
+            // let the audio thread in often, so posts and collects interleave in every possible way
+            if ((sequence & 63) == 0)
+                std::this_thread::yield();
+        }
+
+        writersDone.fetch_add(1, std::memory_order_release);
+    }
+
+    void apply(const uint32_t index, const float value)
+    {
+        uint32_t writer, sequence;
+        decode(value, writer, sequence);
+
+        if (isOutput(index))
+            fail("output parameter collected as a change", index);
+        else if (writer >= kWriters || sequence >= kPostsPerWriter || encode(writer, sequence) != value)
+            fail("value was never posted", index);
+        // a later collect may skip values, but never deliver an older one from the same writer
+        else if (static_cast<int64_t>(sequence) < lastSequence[index][writer])
+            fail("older value delivered after a newer one", index);
+        else
+            lastSequence[index][writer] = sequence;
+
+        applied[index] = value;
+        delivered[index] = true;
+        ++changes;
+    }
+
+    void collect()
+    {
+        mailbox.collect([this](const uint32_t index, const float value) { apply(index, value); });
+    }
+
+    void process()
+    {
+        while (writersDone.load(std::memory_order_acquire) != kWriters)
+        {
+            collect();
+
+            ++blocks;
+            for (const uint32_t index : kOutputs)
+                mailbox.publish(index, static_cast<float>(blocks));
+
+            std::this_thread::yield();
+        }
+    }
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    // large, keep it off the stack
+    std::vector<Stress> stressHolder(1);
+    Stress& stress(stressHolder[0]);
+
+    std::thread audio([&stress] { stress.process(); });
+    std::vector<std::thread> writers;
+
+    for (uint32_t w = 0; w < kWriters; ++w)
+        writers.emplace_back([&stress, w] { stress.write(w); });
+
+    for (std::thread& writer : writers)
+        writer.join();
+
+    audio.join();
+
+    // everything posted is in by now, the last collect must leave the applied values equal to the latest ones
+    stress.collect();
+
+    for (uint32_t i = 0; i < kParamCount; ++i)
+    {
+        bool posted = false;
+
+        for (uint32_t w = 0; w < kWriters; ++w)
+            posted = posted || stress.posted[w][i];
+
+        if (posted && ! stress.delivered[i])
+            stress.fail("posted value never delivered", i);
+        if (posted && stress.applied[i] != stress.mailbox.read(i))
+            stress.fail("applied value is not the latest one", i);
+    }
+
+    const uint64_t posts = static_cast<uint64_t>(kWriters) * kPostsPerWriter;
+    const uint32_t failures = stress.failures.load();
+
+    std::printf("%llu posts and reads, %llu blocks, %llu changes applied, %u failures\n",
+                static_cast<unsigned long long>(posts),
+                static_cast<unsigned long long>(stress.blocks),
+                static_cast<unsigned long long>(stress.changes),
+                failures);
+
+    return failures == 0 ? 0 : 1;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
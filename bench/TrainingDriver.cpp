@@ -0,0 +1,205 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+// Headless host for the profile-guided optimization training run, also used to compare builds.
+// Loads the VST2 binary, sweeps every parameter while processing a fixed test signal and prints the DSP cost.
+// With --ui and a running X server (Xvfb is fine) the editor is opened and idled once per block as well.
+
+#include "DistrhoPluginInfo.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <dlfcn.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static constexpr const float kSampleRate = 48000.0f;
+static constexpr const uint32_t kBlockSize = 512;
+static constexpr const uint32_t kNumBlocks = 6000; // a bit over a minute of audio
+static constexpr const uint32_t kSweepBlocks = 200;
+
+// the parts of the VST2 ABI used here
+struct AEffect;
+typedef intptr_t (*AudioMasterCallback)(AEffect*, int32_t, int32_t, intptr_t, void*, float);
+
+struct AEffect {
+    int32_t magic;
+    intptr_t (*dispatcher)(AEffect*, int32_t, int32_t, intptr_t, void*, float);
+    void (*process)(AEffect*, float**, float**, int32_t);
+    void (*setParameter)(AEffect*, int32_t, float);
+    float (*getParameter)(AEffect*, int32_t);
+    int32_t numPrograms, numParams, numInputs, numOutputs, flags;
+    intptr_t resvd1, resvd2;
+    int32_t initialDelay, realQualities, offQualities;
+    float ioRatio;
+    void* object;
+    void* user;
+    int32_t uniqueID, version;
+    void (*processReplacing)(AEffect*, float**, float**, int32_t);
+};
+
+enum {
+    effOpen = 0,
+    effClose = 1,
+    effSetSampleRate = 10,
+    effSetBlockSize = 11,
+    effMainsChanged = 12,
+    effEditOpen = 14,
+    effEditClose = 15,
+    effEditIdle = 19,
+    audioMasterVersion = 1,
+};
+
+static intptr_t hostCallback(AEffect*, const int32_t opcode, int32_t, intptr_t, void*, float)
+{
+    return opcode == audioMasterVersion ? 2400 : 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Normalized value of @a param at @a block, so that every parameter is swept across its range at its own pace.
+   Some parameters stay in the ranges where their stage is active, so the training covers the busy paths too.
+ */
+static float sweep(const uint32_t param, const uint32_t block)
+{
+    const float phase = static_cast<float>(block % (kSweepBlocks * (param + 2))) / (kSweepBlocks * (param + 2));
+    const float tri = phase < 0.5f ? 2.0f * phase : 2.0f - 2.0f * phase;
+
+    switch (param)
+    {
+    case kParamGain:
+        return 0.6f + 0.2f * tri;
+    case kParamGateThreshold:
+        return 0.3f + 0.5f * tri;
+    case kParamCompRatio:
+        return 0.05f + 0.5f * tri;
+    case kParamCompThreshold:
+        return 0.4f + 0.4f * tri;
+    case kParamAlignment:
+        return 1.0f;
+    default:
+        return tri;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const char* path = nullptr;
+    bool withUI = false;
+
+   #ifdef TRAINING_DRIVER_VST2
+    path = TRAINING_DRIVER_VST2;
+   #endif
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--ui") == 0)
+            withUI = true;
+        else
+            path = argv[i];
+    }
+
+    if (path == nullptr)
+    {
+        std::fprintf(stderr, "usage: %s [--ui] plugin-vst2.so\n", argv[0]);
+        return 2;
+    }
+
+    if (withUI && std::getenv("DISPLAY") == nullptr)
+    {
+        std::fprintf(stderr, "no DISPLAY set, training without the UI\n");
+        withUI = false;
+    }
+
+    void* const lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+
+    if (lib == nullptr)
+    {
+        std::fprintf(stderr, "failed to load %s: %s\n", path, dlerror());
+        return 1;
+    }
+
+    typedef AEffect* (*entry_t)(AudioMasterCallback);
+    const entry_t entry = reinterpret_cast<entry_t>(dlsym(lib, "VSTPluginMain"));
+    AEffect* const effect = entry != nullptr ? entry(hostCallback) : nullptr;
+
+    if (effect == nullptr || effect->processReplacing == nullptr)
+    {
+        std::fprintf(stderr, "%s is not a usable VST2 plugin\n", path);
+        dlclose(lib);
+        return 1;
+    }
+
+    effect->dispatcher(effect, effOpen, 0, 0, nullptr, 0.0f);
+    effect->dispatcher(effect, effSetSampleRate, 0, 0, nullptr, kSampleRate);
+    effect->dispatcher(effect, effSetBlockSize, 0, kBlockSize, nullptr, 0.0f);
+    effect->dispatcher(effect, effMainsChanged, 0, 1, nullptr, 0.0f);
+
+    if (withUI)
+        effect->dispatcher(effect, effEditOpen, 0, 0, nullptr, 0.0f);
+
+    // program material: a decaying chord with a noise floor, bursts and gaps, different on both channels
+    std::vector<float> left(kBlockSize), right(kBlockSize), outLeft(kBlockSize), outRight(kBlockSize);
+    float* inputs[2] = { left.data(), right.data() };
+    float* outputs[2] = { outLeft.data(), outRight.data() };
+    std::vector<float> values(kParamCount, -1.0f);
+    uint32_t noise = 1;
+
+    std::chrono::steady_clock::duration dspTime {};
+
+    for (uint32_t b = 0; b < kNumBlocks; ++b)
+    {
+        const float level = (b / 50) % 4 == 3 ? 0.0005f : 0.5f * std::exp(-static_cast<float>(b % 50) * 0.05f);
+
+        for (uint32_t i = 0; i < kBlockSize; ++i)
+        {
+            const float t = static_cast<float>(b * kBlockSize + i) / kSampleRate;
+            noise = noise * 1664525u + 1013904223u;
+            const float n = static_cast<float>(noise >> 8) / 16777216.0f - 0.5f;
+
+            left[i] = level * (std::sin(6.2831853f * 220.0f * t) + 0.5f * std::sin(6.2831853f * 277.2f * t)) + 0.01f * n;
+            right[i] = level * (std::sin(6.2831853f * 329.6f * t) + 0.3f * std::sin(6.2831853f * 55.0f * t)) - 0.01f * n;
+        }
+
+        // like host automation, only send values that changed
+        for (uint32_t p = 0; p < kParamCount; ++p)
+        {
+            const float value = sweep(p, b);
+
+            if (values[p] != value)
+            {
+                values[p] = value;
+                effect->setParameter(effect, static_cast<int32_t>(p), value);
+            }
+        }
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        effect->processReplacing(effect, inputs, outputs, kBlockSize);
+        dspTime += std::chrono::steady_clock::now() - start;
+
+        if (withUI)
+            effect->dispatcher(effect, effEditIdle, 0, 0, nullptr, 0.0f);
+    }
+
+    if (withUI)
+        effect->dispatcher(effect, effEditClose, 0, 0, nullptr, 0.0f);
+
+    effect->dispatcher(effect, effMainsChanged, 0, 0, nullptr, 0.0f);
+    effect->dispatcher(effect, effClose, 0, 0, nullptr, 0.0f);
+    dlclose(lib);
+
+    const double ns = std::chrono::duration<double, std::nano>(dspTime).count();
+    std::printf("dsp %.3f ns/frame\n", ns / (static_cast<double>(kNumBlocks) * kBlockSize));
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+// Overview of every running plugin instance, read from the shared meter table (see src/MeterBridge.hpp).
+// The table is polled at a fixed frame rate, plugin instances never wait on this application.
+
+#include "Application.hpp"
+#include "DearImGui.hpp"
+#include "MeterBridge.hpp"
+
+START_NAMESPACE_DGL
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static constexpr const uint kFrameRate = 30;
+static constexpr const float kLevelFloorDB = -60.0f;
+
+class MeterBridgeWidget : public ImGuiTopLevelWidget,
+                          public IdleCallback
+{
+    const MeterBridgeTable* fTable = nullptr;
+
+public:
+    explicit MeterBridgeWidget(Window& window)
+        : ImGuiTopLevelWidget(window)
+    {
+        window.addIdleCallback(this, 1000 / kFrameRate);
+    }
+
+protected:
+    void idleCallback() override
+    {
+        // plugins create the table, and a new one after the last instance left, so keep following the name
+        fTable = DISTRHO_NAMESPACE::MeterBridge::refreshSharedTable(fTable);
+
+        repaint();
+    }
+
+    void onImGuiDisplay() override
+    {
+        ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+        ImGui::SetNextWindowSize(ImVec2(getWidth(), getHeight()));
+
+        if (ImGui::Begin("Meter Bridge", nullptr, ImGuiWindowFlags_NoDecoration))
+        {
+            if (fTable == nullptr)
+                ImGui::TextUnformatted("No plugin instance is running.");
+            else
+                drawTable();
+        }
+        ImGui::End();
+    }
+
+private:
+    void drawTable()
+    {
+        const ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_ScrollY;
+
+        if (! ImGui::BeginTable("instances", 7, flags))
+            return;
+
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Process", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Gain", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Level L");
+        ImGui::TableSetupColumn("Level R");
+        ImGui::TableSetupColumn("Gate GR", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Comp GR", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableSetupColumn("Correlation", ImGuiTableColumnFlags_WidthFixed);
+        ImGui::TableHeadersRow();
+
+        for (uint32_t i = 0; i < DISTRHO_NAMESPACE::kMeterBridgeSlots; ++i)
+        {
+            const DISTRHO_NAMESPACE::MeterBridgeSlot& slot(fTable->slots[i]);
+            float values[DISTRHO_NAMESPACE::kMeterBridgeValueCount];
+
+            if (! DISTRHO_NAMESPACE::MeterBridge::read(slot, values))
+                continue;
+
+            ImGui::PushID(static_cast<int>(i));
+            ImGui::TableNextRow();
+
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", slot.process.load(std::memory_order_relaxed));
+            ImGui::TableNextColumn();
+            ImGui::Text("%+.1f dB", values[DISTRHO_NAMESPACE::kMeterBridgeGain]);
+            ImGui::TableNextColumn();
+            levelBar(values[DISTRHO_NAMESPACE::kMeterBridgeLevelLeft]);
+            ImGui::TableNextColumn();
+            levelBar(values[DISTRHO_NAMESPACE::kMeterBridgeLevelRight]);
+            ImGui::TableNextColumn();
+            ImGui::Text("-%.1f dB", values[DISTRHO_NAMESPACE::kMeterBridgeGateReduction]);
+            ImGui::TableNextColumn();
+            ImGui::Text("-%.1f dB", values[DISTRHO_NAMESPACE::kMeterBridgeCompReduction]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%+.2f", values[DISTRHO_NAMESPACE::kMeterBridgeCorrelation]);
+
+            ImGui::PopID();
+        }
+
+        ImGui::EndTable();
+    }
+
+    static void levelBar(const float levelDB)
+    {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.1f dB", levelDB);
+
+        ImGui::ProgressBar(1.0f - levelDB / kLevelFloorDB, ImVec2(-1.0f, 0.0f), text);
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(MeterBridgeWidget)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DGL
+
+int main()
+{
+    USE_NAMESPACE_DGL;
+
+    Application app;
+    Window window(app);
+    window.setTitle("Meter Bridge");
+    window.setSize(720, 480);
+    window.setResizable(true);
+
+    MeterBridgeWidget widget(window);
+    window.show();
+    app.exec();
+
+    return 0;
+}
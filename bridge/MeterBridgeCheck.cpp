@@ -0,0 +1,158 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+// Checks the cross-process path of the meter table, headless: a second process opens plugin-side slots and publishes
+// to them while this one polls the table exactly as the meter bridge application does, through refreshSharedTable().
+// Covers an instance showing up, the same instance after its process closed every slot and opened again (a host
+// reactivating on a sample rate change), and the shared name being gone once the last instance left.
+// Returns non-zero on failure.
+
+#include "MeterBridge.hpp"
+
+#include <cstdio>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+USE_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static uint32_t failures = 0;
+
+static void check(const bool condition, const char* const message)
+{
+    if (condition)
+        return;
+
+    std::fprintf(stderr, "FAIL: %s\n", message);
+    ++failures;
+}
+
+/**
+   Find @a gain in the gain column of the live slots, polling like the bridge until it shows up or a second passed.
+ */
+static bool waitForGain(const MeterBridgeTable*& table, const float gain)
+{
+    for (int attempt = 0; attempt < 100; ++attempt)
+    {
+        table = MeterBridge::refreshSharedTable(table);
+
+        if (table != nullptr)
+        {
+            for (uint32_t i = 0; i < kMeterBridgeSlots; ++i)
+            {
+                float values[kMeterBridgeValueCount];
+
+                if (MeterBridge::read(table->slots[i], values) && values[kMeterBridgeGain] == gain)
+                    return true;
+            }
+        }
+
+        usleep(10000);
+    }
+
+    return false;
+}
+
+/**
+   Tell the other process that we are done with a step, and wait until it is done with its own.
+ */
+static bool handshake(const int from, const int to)
+{
+    char byte = 0;
+    return write(to, &byte, 1) == 1 && read(from, &byte, 1) == 1;
+}
+
+/**
+   The plugin side, in its own process: publishes @a gain from two instances and closes both, then does it again
+   with @a gain + 1 in the same process, stopping after each step until the reader checked it.
+ */
+static int runInstances(const int from, const int to, const float gain)
+{
+    for (int round = 0; round < 2; ++round)
+    {
+        {
+            MeterBridge first, second;
+            first.open();
+            second.open();
+
+            float values[kMeterBridgeValueCount] = {};
+            values[kMeterBridgeGain] = gain + round;
+            first.publish(values);
+
+            values[kMeterBridgeGain] = -1.0f;
+            second.publish(values);
+
+            if (! handshake(from, to))
+                return 1;
+        }
+
+        if (! handshake(from, to))
+            return 1;
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    // a table left over by a run that failed halfway would hide nothing, but start clean anyway
+    shm_unlink(kMeterBridgeName);
+
+    int commandPipe[2], readyPipe[2];
+
+    if (pipe(commandPipe) != 0 || pipe(readyPipe) != 0)
+    {
+        std::perror("pipe");
+        return 1;
+    }
+
+    const float gain = 3.0f;
+    const pid_t child = fork();
+
+    if (child == 0)
+        _exit(runInstances(commandPipe[0], readyPipe[1], gain));
+
+    if (child < 0)
+    {
+        std::perror("fork");
+        return 1;
+    }
+
+    const MeterBridgeTable* table = nullptr;
+    char byte = 0;
+
+    for (int round = 0; round < 2 && failures == 0; ++round)
+    {
+        check(read(readyPipe[0], &byte, 1) == 1, "instance process went away");
+        check(waitForGain(table, gain + round),
+              round == 0 ? "instance of another process not visible"
+                         : "instance of another process not visible after it reopened");
+
+        // once the instances closed, the reader drops its mapping, and the name must be gone
+        check(handshake(readyPipe[0], commandPipe[1]), "instance process went away");
+        table = MeterBridge::refreshSharedTable(table);
+        check(table == nullptr, "shared table left behind after the last instance closed");
+        check(write(commandPipe[1], &byte, 1) == 1, "instance process went away");
+    }
+
+    // lets the instance process run to its end, even after a failure
+    close(commandPipe[1]);
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    check(WIFEXITED(status) && WEXITSTATUS(status) == 0, "instance process failed");
+    MeterBridge::unmapSharedTable(table);
+
+    std::printf("%u failures\n", failures);
+    return failures == 0 ? 0 : 1;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
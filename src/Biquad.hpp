@@ -0,0 +1,231 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef BIQUAD_HPP_INCLUDED
+#define BIQUAD_HPP_INCLUDED
+
+#include "FastMath.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Normalized biquad coefficients (a0 == 1).
+ */
+struct BiquadCoefficients {
+    float b0, b1, b2, a1, a2;
+
+    static constexpr BiquadCoefficients identity() noexcept
+    {
+        return { 1.f, 0.f, 0.f, 0.f, 0.f };
+    }
+
+    bool isIdentity() const noexcept
+    {
+        return b0 == 1.f && b1 == 0.f && b2 == 0.f && a1 == 0.f && a2 == 0.f;
+    }
+
+   /**
+      RBJ cookbook designs, using the FastMath approximations instead of std trig and pow.
+      Frequencies are clamped below Nyquist.
+    */
+    static BiquadCoefficients highPass(const float freq, const float q, const double sampleRate) noexcept
+    {
+        float sw, cw;
+        FastMath::sinCos(omega(freq, sampleRate), sw, cw);
+        const float alpha = sw / (2.f * q);
+
+        return normalize((1.f + cw) * 0.5f, -(1.f + cw), (1.f + cw) * 0.5f,
+                         1.f + alpha, -2.f * cw, 1.f - alpha);
+    }
+
+    static BiquadCoefficients lowShelf(const float freq, const float gainDB, const double sampleRate) noexcept
+    {
+        float sw, cw;
+        FastMath::sinCos(omega(freq, sampleRate), sw, cw);
+        const float A = FastMath::dbToGain(gainDB * 0.5f);
+        const float k = FastMath::dbToGain(gainDB * 0.25f) * sw * 1.41421356f; // 2 * sqrt(A) * alpha, S = 1
+
+        return normalize(A * ((A + 1.f) - (A - 1.f) * cw + k),
+                         2.f * A * ((A - 1.f) - (A + 1.f) * cw),
+                         A * ((A + 1.f) - (A - 1.f) * cw - k),
+                         (A + 1.f) + (A - 1.f) * cw + k,
+                         -2.f * ((A - 1.f) + (A + 1.f) * cw),
+                         (A + 1.f) + (A - 1.f) * cw - k);
+    }
+
+    static BiquadCoefficients highShelf(const float freq, const float gainDB, const double sampleRate) noexcept
+    {
+        float sw, cw;
+        FastMath::sinCos(omega(freq, sampleRate), sw, cw);
+        const float A = FastMath::dbToGain(gainDB * 0.5f);
+        const float k = FastMath::dbToGain(gainDB * 0.25f) * sw * 1.41421356f; // 2 * sqrt(A) * alpha, S = 1
+
+        return normalize(A * ((A + 1.f) + (A - 1.f) * cw + k),
+                         -2.f * A * ((A - 1.f) + (A + 1.f) * cw),
+                         A * ((A + 1.f) + (A - 1.f) * cw - k),
+                         (A + 1.f) - (A - 1.f) * cw + k,
+                         2.f * ((A - 1.f) - (A + 1.f) * cw),
+                         (A + 1.f) - (A - 1.f) * cw - k);
+    }
+
+    static BiquadCoefficients bell(const float freq, const float gainDB, const float q, const double sampleRate) noexcept
+    {
+        float sw, cw;
+        FastMath::sinCos(omega(freq, sampleRate), sw, cw);
+        const float A = FastMath::dbToGain(gainDB * 0.5f);
+        const float alpha = sw / (2.f * q);
+
+        return normalize(1.f + alpha * A, -2.f * cw, 1.f - alpha * A,
+                         1.f + alpha / A, -2.f * cw, 1.f - alpha / A);
+    }
+
+private:
+    static float omega(const float freq, const double sampleRate) noexcept
+    {
+        return FastMath::kTwoPi * std::min(freq, static_cast<float>(sampleRate * 0.49)) / static_cast<float>(sampleRate);
+    }
+
+    static BiquadCoefficients normalize(const float b0, const float b1, const float b2,
+                                        const float a0, const float a1, const float a2) noexcept
+    {
+        const float inv = 1.f / a0;
+        return { b0 * inv, b1 * inv, b2 * inv, a1 * inv, a2 * inv };
+    }
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   A cascade of transposed direct-form II biquads, processing @a kLanes channels at once.
+
+   Audio is given as interleaved frames of @a kLanes samples, so the per-lane loops map directly to SIMD registers.
+   All lanes share the same coefficients, which are linearly interpolated from their current value to a new target
+   across each block given to process(), so automation stays smooth without redesigning filters per sample.
+ */
+template <uint32_t kStages, uint32_t kLanes>
+class BiquadCascade
+{
+public:
+    BiquadCascade() noexcept
+    {
+        for (uint32_t s = 0; s < kStages; ++s)
+            fCoefs[s] = fTargets[s] = BiquadCoefficients::identity();
+
+        clear();
+    }
+
+   /**
+      Reset the filter memory.
+    */
+    void clear() noexcept
+    {
+        std::memset(fState, 0, sizeof(fState));
+    }
+
+   /**
+      Set the coefficients that the next process() call ramps to.
+    */
+    void setTarget(const uint32_t stage, const BiquadCoefficients& coefs) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(stage < kStages,);
+
+        fTargets[stage] = coefs;
+    }
+
+   /**
+      Jump to the target coefficients immediately, for use when not processing.
+    */
+    void clearToTargets() noexcept
+    {
+        for (uint32_t s = 0; s < kStages; ++s)
+            fCoefs[s] = fTargets[s];
+    }
+
+   /**
+      Whether all stages are pass-through, so process() can be skipped altogether.
+    */
+    bool isIdle() const noexcept
+    {
+        for (uint32_t s = 0; s < kStages; ++s)
+            if (! fCoefs[s].isIdentity() || ! fTargets[s].isIdentity())
+                return false;
+
+        return true;
+    }
+
+   /**
+      Filter @a frames interleaved frames in place.
+      Stages whose coefficients are identity and not changing are skipped, their memory is left as it was when they
+      settled and gets zeroed once they move away from identity again, so re-enabling a band does not click.
+    */
+    void process(float* const data, const uint32_t frames) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(frames != 0,);
+
+        const float inv = 1.f / static_cast<float>(frames);
+
+        for (uint32_t s = 0; s < kStages; ++s)
+        {
+            BiquadCoefficients c = fCoefs[s];
+            const BiquadCoefficients& t = fTargets[s];
+
+            if (c.isIdentity())
+            {
+                if (t.isIdentity())
+                    continue;
+
+                std::memset(fState[s], 0, sizeof(fState[s]));
+            }
+
+            const BiquadCoefficients d = {
+                (t.b0 - c.b0) * inv, (t.b1 - c.b1) * inv, (t.b2 - c.b2) * inv,
+                (t.a1 - c.a1) * inv, (t.a2 - c.a2) * inv
+            };
+
+            float* const s1 = fState[s][0];
+            float* const s2 = fState[s][1];
+
+            for (uint32_t i = 0; i < frames; ++i)
+            {
+                c.b0 += d.b0;
+                c.b1 += d.b1;
+                c.b2 += d.b2;
+                c.a1 += d.a1;
+                c.a2 += d.a2;
+
+                float* const x = data + i * kLanes;
+
+                for (uint32_t l = 0; l < kLanes; ++l)
+                {
+                    const float in = x[l];
+                    const float out = c.b0 * in + s1[l];
+                    s1[l] = c.b1 * in - c.a1 * out + s2[l];
+                    s2[l] = c.b2 * in - c.a2 * out;
+                    x[l] = out;
+                }
+            }
+
+            // land exactly on target, avoiding accumulated rounding
+            fCoefs[s] = t;
+        }
+    }
+
+private:
+    BiquadCoefficients fCoefs[kStages];
+    BiquadCoefficients fTargets[kStages];
+    float fState[kStages][2][kLanes];
+
+    DISTRHO_DECLARE_NON_COPYABLE(BiquadCascade)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // BIQUAD_HPP_INCLUDED
@@ -0,0 +1,196 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef DELAY_HPP_INCLUDED
+#define DELAY_HPP_INCLUDED
+
+#include "Simd.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Per-channel fractional delay for @a kChannels planar channels.
+
+   Each channel has a power-of-two ring buffer with masked indexing, stored twice in a row (a mirrored ring),
+   so the taps for a whole block are always contiguous and never need to wrap.
+   Fractional delays use 3rd order Lagrange interpolation, which is only accurate between its two middle taps,
+   so all channels are delayed by 1 extra sample. That sample is reported as latency by the plugin.
+
+   Delay changes take effect at the next block without crossfading, this stage is meant for alignment rather than
+   for automation.
+ */
+template <uint32_t kChannels>
+class DelayLine
+{
+public:
+    static constexpr const uint32_t kLatency = 1;
+
+    DelayLine() noexcept
+        : fBuffer(nullptr),
+          fSize(0),
+          fMask(0),
+          fMaxBlockFrames(0),
+          fMaxDelayFrames(0),
+          fWritePos(0)
+    {
+        for (uint32_t c = 0; c < kChannels; ++c)
+            fDelays[c] = 0.f;
+    }
+
+    ~DelayLine() noexcept
+    {
+        release();
+    }
+
+   /**
+      Reserve memory for delays up to @a maxDelayFrames and blocks of up to @a maxBlockFrames.
+      @note Not realtime-safe, must not be called from run().
+    */
+    void allocate(const uint32_t maxDelayFrames, const uint32_t maxBlockFrames)
+    {
+        // the oldest tap of a block, plus the block itself, must fit in the ring
+        const uint32_t size = d_nextPowerOf2(maxBlockFrames + maxDelayFrames + kLatency + 3);
+
+        fMaxBlockFrames = maxBlockFrames;
+        fMaxDelayFrames = maxDelayFrames;
+
+        if (size != fSize)
+        {
+            release();
+
+            fBuffer = new float[2 * size * kChannels];
+            fSize = size;
+            fMask = size - 1;
+        }
+
+        clear();
+    }
+
+   /**
+      Free all reserved memory.
+      @note Not realtime-safe, must not be called from run().
+    */
+    void release() noexcept
+    {
+        delete[] fBuffer;
+        fBuffer = nullptr;
+        fSize = fMask = 0;
+    }
+
+    void clear() noexcept
+    {
+        if (fBuffer != nullptr)
+            std::memset(fBuffer, 0, sizeof(float) * 2 * fSize * kChannels);
+
+        fWritePos = 0;
+    }
+
+   /**
+      Set the delay of @a channel in frames, not counting the fixed latency.
+    */
+    void setDelay(const uint32_t channel, const float frames) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(channel < kChannels,);
+
+        fDelays[channel] = std::max(0.f, std::min(static_cast<float>(fMaxDelayFrames), frames));
+    }
+
+   /**
+      Whether all channels have zero delay, so the stage can be bypassed without latency.
+    */
+    bool isIdle() const noexcept
+    {
+        for (uint32_t c = 0; c < kChannels; ++c)
+            if (fDelays[c] != 0.f)
+                return false;
+
+        return true;
+    }
+
+   /**
+      Delay @a frames samples of @a channel from @a input into @a output.
+      Call this once for every channel per block, then advance() once.
+    */
+    void process(const uint32_t channel, const float* const __restrict input, float* const __restrict output,
+                 const uint32_t frames) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(channel < kChannels,);
+        DISTRHO_SAFE_ASSERT_RETURN(frames <= fMaxBlockFrames,);
+
+        float* const ring = fBuffer + 2 * fSize * channel;
+
+        // write the block into both copies of the ring, in up to 2 pieces
+        const uint32_t first = std::min(frames, fSize - fWritePos);
+        std::memcpy(ring + fWritePos, input, sizeof(float) * first);
+        std::memcpy(ring + fWritePos + fSize, input, sizeof(float) * first);
+        std::memcpy(ring, input + first, sizeof(float) * (frames - first));
+        std::memcpy(ring + fSize, input + first, sizeof(float) * (frames - first));
+
+        const float delay = fDelays[channel] + kLatency;
+        const uint32_t whole = static_cast<uint32_t>(delay);
+        const float f = delay - static_cast<float>(whole);
+
+        // taps at delays whole-1 .. whole+2, each one contiguous over the block thanks to the mirrored copy
+        const float* const __restrict x0 = ring + ((fWritePos - whole + 1) & fMask);
+        const float* const __restrict x1 = ring + ((fWritePos - whole) & fMask);
+        const float* const __restrict x2 = ring + ((fWritePos - whole - 1) & fMask);
+        const float* const __restrict x3 = ring + ((fWritePos - whole - 2) & fMask);
+
+        if (f == 0.f)
+        {
+            std::memcpy(output, x1, sizeof(float) * frames);
+            return;
+        }
+
+        const float h0 = -f * (f - 1.f) * (f - 2.f) * (1.f / 6.f);
+        const float h1 = (f + 1.f) * (f - 1.f) * (f - 2.f) * 0.5f;
+        const float h2 = -(f + 1.f) * f * (f - 2.f) * 0.5f;
+        const float h3 = (f + 1.f) * f * (f - 1.f) * (1.f / 6.f);
+
+        const Float4 c0 = Float4::broadcast(h0);
+        const Float4 c1 = Float4::broadcast(h1);
+        const Float4 c2 = Float4::broadcast(h2);
+        const Float4 c3 = Float4::broadcast(h3);
+
+        uint32_t i = 0;
+
+        for (; i + 4 <= frames; i += 4)
+        {
+            const Float4 y = c0 * Float4::load(x0 + i) + c1 * Float4::load(x1 + i)
+                           + c2 * Float4::load(x2 + i) + c3 * Float4::load(x3 + i);
+            y.store(output + i);
+        }
+
+        for (; i < frames; ++i)
+            output[i] = h0 * x0[i] + h1 * x1[i] + h2 * x2[i] + h3 * x3[i];
+    }
+
+   /**
+      Move the write position past a block of @a frames, after all channels were processed.
+    */
+    void advance(const uint32_t frames) noexcept
+    {
+        fWritePos = (fWritePos + frames) & fMask;
+    }
+
+private:
+    float* fBuffer;
+    uint32_t fSize, fMask;
+    uint32_t fMaxBlockFrames, fMaxDelayFrames;
+    uint32_t fWritePos;
+    float fDelays[kChannels];
+
+    DISTRHO_DECLARE_NON_COPYABLE(DelayLine)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // DELAY_HPP_INCLUDED
@@ -56,13 +56,13 @@
    @note DO NOT USE THIS UNLESS STRICTLY NECESSARY!!
          Try to avoid it at all costs!
  */
-#define DISTRHO_PLUGIN_WANT_DIRECT_ACCESS 0
+#define DISTRHO_PLUGIN_WANT_DIRECT_ACCESS 1
 
 /**
    Whether the plugin introduces latency during audio or midi processing.
    @see Plugin::setLatency(uint32_t)
  */
-#define DISTRHO_PLUGIN_WANT_LATENCY 0
+#define DISTRHO_PLUGIN_WANT_LATENCY 1
 
 /**
    Whether the plugin wants MIDI input.@n
@@ -81,8 +81,13 @@
    Not all hosts or plugin formats support this,
    so Plugin::canRequestParameterValueChanges() can be used to query support at runtime.
    @see Plugin::requestParameterValueChange(uint32_t, float)
+   Used to hand remote changes from the OSC server to the host, see src/OscServer.hpp.
  */
-#define DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST 0
+#ifdef IMGUI_PLUGIN_OSC
+# define DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST 1
+#else
+# define DISTRHO_PLUGIN_WANT_PARAMETER_VALUE_CHANGE_REQUEST 0
+#endif
 
 /**
    Whether the plugin provides its own internal programs.
@@ -96,7 +101,7 @@
    @see Plugin::initState(uint32_t, String&, String&)
    @see Plugin::setState(const char*, const char*)
  */
-#define DISTRHO_PLUGIN_WANT_STATE 0
+#define DISTRHO_PLUGIN_WANT_STATE 1
 
 /**
    Whether the plugin implements the full state API.
@@ -332,3 +337,63 @@
    @note This macro is required when building CLAP plugins
 */
 #define DISTRHO_PLUGIN_CLAP_ID "studio.kx.distrho.examples.imguisimplegain"
+
+/**
+   Plugin parameters, shared between the DSP and UI sides.@n
+   New parameters must be appended before kParamCount, so that saved sessions keep their indexes.
+ */
+enum Parameters {
+    kParamGain = 0,
+    kParamHighPassFreq,
+    kParamLowShelfFreq,
+    kParamLowShelfGain,
+    kParamBellFreq,
+    kParamBellGain,
+    kParamBellQ,
+    kParamHighShelfFreq,
+    kParamHighShelfGain,
+    kParamGateThreshold,
+    kParamGateRatio,
+    kParamGateRange,
+    kParamGateHysteresis,
+    kParamGateHold,
+    kParamGateAttack,
+    kParamGateRelease,
+    kParamGateReduction,
+    kParamCompThreshold,
+    kParamCompRatio,
+    kParamCompKnee,
+    kParamCompAttack,
+    kParamCompRelease,
+    kParamCompMakeup,
+    kParamCompLink,
+    kParamCompReduction,
+    kParamCorrelation,
+    kParamBalance,
+    kParamAlignment,
+    kParamDelayLeft,
+    kParamDelayRight,
+    kParamPolarityLeft,
+    kParamPolarityRight,
+    kParamDither,
+    kParamDitherShaping,
+    kParamMeterMode,
+    kParamMeterLeft,
+    kParamMeterRight,
+    kParamCount
+};
+
+/**
+   Plugin states, shared between the DSP and UI sides.
+ */
+enum States {
+    kStateImGuiSettings = 0,
+    kStateCount
+};
+
+/**
+   Keys of the plugin states, indexed by the States enum.
+ */
+static const char* const kStateKeys[kStateCount] = {
+    "imgui_settings",
+};
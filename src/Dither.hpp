@@ -0,0 +1,218 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef DITHER_HPP_INCLUDED
+#define DITHER_HPP_INCLUDED
+
+#include "Simd.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+// dither noise restarts from this seed on activate, so offline renders are bit-reproducible (see bench/DitherCheck.cpp)
+static constexpr const uint32_t kDitherSeed = 0x5eed1234u;
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Several independent xorshift32 generators run side by side.
+
+   Each call fills a whole block, and the generators are interleaved so the integer loop vectorizes.
+   Everything is plain integer math, so a given seed produces the same sequence on every platform.
+ */
+class DitherRandom
+{
+public:
+    static constexpr const uint32_t kStreams = 4;
+
+    DitherRandom() noexcept
+    {
+        seed(1);
+    }
+
+   /**
+      Restart all generators from @a value.
+    */
+    void seed(uint32_t value) noexcept
+    {
+        for (uint32_t j = 0; j < kStreams; ++j)
+        {
+            // splitmix32 step, so neighbouring streams are unrelated
+            value += 0x9e3779b9u;
+            uint32_t z = value;
+            z = (z ^ (z >> 16)) * 0x85ebca6bu;
+            z = (z ^ (z >> 13)) * 0xc2b2ae35u;
+            z ^= z >> 16;
+
+            // xorshift state must never be zero
+            fState[j] = z != 0 ? z : 0x6d2b79f5u;
+        }
+    }
+
+   /**
+      Fill @a count values with triangular noise in [-1, 1), @a count must be a multiple of kStreams.
+    */
+    void fillTriangular(float* const __restrict output, const uint32_t count) noexcept
+    {
+        uint32_t state[kStreams];
+        std::memcpy(state, fState, sizeof(state));
+
+        for (uint32_t i = 0; i < count; i += kStreams)
+        {
+            for (uint32_t j = 0; j < kStreams; ++j)
+            {
+                const uint32_t a = next(state[j]);
+                const uint32_t b = next(state[j]);
+
+                // 23 random mantissa bits make a float in [1, 2), the difference of two is triangular
+                output[i + j] = FastMath::bitsToFloat(static_cast<int32_t>((a >> 9) | 0x3f800000u))
+                              - FastMath::bitsToFloat(static_cast<int32_t>((b >> 9) | 0x3f800000u));
+            }
+        }
+
+        std::memcpy(fState, state, sizeof(state));
+    }
+
+private:
+    static inline uint32_t next(uint32_t& x) noexcept
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        return x;
+    }
+
+    uint32_t fState[kStreams];
+
+    DISTRHO_DECLARE_NON_COPYABLE(DitherRandom)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   TPDF dither with optional error-feedback noise shaping, for interleaved frames of @a kLanes samples.
+
+   The noise for a block is generated up front with prepare(), and processFrame() is then called from the
+   final output pass so dithering does not need a pass of its own.
+ */
+template <uint32_t kLanes>
+class Dither
+{
+    static_assert(kLanes % 4 == 0, "lanes must be padded to a multiple of 4");
+    static_assert(kLanes % DitherRandom::kStreams == 0, "lanes must be a multiple of the random streams");
+
+public:
+    enum Shaping {
+        kShapingNone = 0,
+        kShapingFirstOrder,
+        kShapingSecondOrder,
+        kShapingWeighted,
+        kShapingCount
+    };
+
+    Dither() noexcept
+        : fEnabled(false),
+          fScale(1.f),
+          fInvScale(1.f)
+    {
+        setup(0, kShapingNone);
+        reset(1);
+    }
+
+   /**
+      Restart the noise from @a seed and clear the error memory, for reproducible output.
+    */
+    void reset(const uint32_t seed) noexcept
+    {
+        fRandom.seed(seed);
+        std::memset(fError, 0, sizeof(fError));
+    }
+
+   /**
+      Set the target word length, where 0 disables dithering, and the noise shaping filter.
+    */
+    void setup(const uint32_t bits, const uint32_t shaping) noexcept
+    {
+        // error feedback coefficients, noise transfer is 1 - h1 z^-1 - h2 z^-2 - h3 z^-3
+        static constexpr const float kFilters[kShapingCount][3] = {
+            { 0.f, 0.f, 0.f },
+            { 1.f, 0.f, 0.f },        // (1 - z^-1)
+            { 2.f, -1.f, 0.f },       // (1 - z^-1)^2
+            { 1.623f, -0.982f, 0.109f }, // 3 tap F-weighted (Wannamaker)
+        };
+
+        fEnabled = bits != 0;
+        fScale = std::ldexp(1.f, static_cast<int>(bits) - 1);
+        fInvScale = 1.f / fScale;
+
+        const uint32_t s = shaping < kShapingCount ? shaping : 0;
+
+        for (uint32_t k = 0; k < 3; ++k)
+            fFilter[k] = kFilters[s][k];
+    }
+
+    bool isEnabled() const noexcept
+    {
+        return fEnabled;
+    }
+
+   /**
+      Generate the noise for @a frames frames into @a noise, which must hold frames * kLanes values.
+    */
+    void prepare(float* const noise, const uint32_t frames) noexcept
+    {
+        fRandom.fillTriangular(noise, frames * kLanes);
+    }
+
+   /**
+      Dither and quantize one frame in place, with @a noise pointing to the matching frame of the prepared block.
+    */
+    inline void processFrame(float* const frame, const float* const noise) noexcept
+    {
+        const Float4 scale = Float4::broadcast(fScale);
+        const Float4 invScale = Float4::broadcast(fInvScale);
+        const Float4 h1 = Float4::broadcast(fFilter[0]);
+        const Float4 h2 = Float4::broadcast(fFilter[1]);
+        const Float4 h3 = Float4::broadcast(fFilter[2]);
+
+        for (uint32_t l = 0; l < kLanes; l += 4)
+        {
+            const Float4 e1 = Float4::load(fError[0] + l);
+            const Float4 e2 = Float4::load(fError[1] + l);
+            const Float4 e3 = Float4::load(fError[2] + l);
+
+            // work in units of the target LSB
+            const Float4 v = Float4::load(frame + l) * scale - (h1 * e1 + h2 * e2 + h3 * e3);
+            const Float4 q = simd::round(v + Float4::load(noise + l));
+
+            (q * invScale).store(frame + l);
+
+            e2.store(fError[2] + l);
+            e1.store(fError[1] + l);
+            (q - v).store(fError[0] + l);
+        }
+    }
+
+private:
+    DitherRandom fRandom;
+
+    bool fEnabled;
+    float fScale, fInvScale;
+    float fFilter[3];
+
+    // quantization error history in LSB units, most recent first
+    float fError[3][kLanes];
+
+    DISTRHO_DECLARE_NON_COPYABLE(Dither)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // DITHER_HPP_INCLUDED
@@ -0,0 +1,632 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef DYNAMICS_HPP_INCLUDED
+#define DYNAMICS_HPP_INCLUDED
+
+#include "Simd.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+// envelope floor at -120 dB, keeps the detectors out of denormal range
+static constexpr const float kDynamicsFloor = 1e-6f;
+
+// range of the gain computer tables, in log2 units
+static constexpr const float kDynamicsMinLog2 = -20.f;
+static constexpr const float kDynamicsMaxLog2 = 4.f;
+
+// dynamics stages work through their input in pieces of this many frames, using stack buffers
+static constexpr const uint32_t kDynamicsChunkSize = 64;
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   One-pole smoothing coefficient for a time constant in milliseconds.
+ */
+static inline float dynamicsCoefficient(const float ms, const double sampleRate) noexcept
+{
+    return ms > 0.f ? static_cast<float>(std::exp(-1.0 / (ms * 0.001 * sampleRate))) : 0.f;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Peak envelope follower with instant attack, shared by all dynamics stages.
+
+   Works on interleaved frames of @a kLanes samples like BiquadCascade, one group of 4 lanes at a time,
+   so the envelope of each group stays in a register across the whole block.
+ */
+template <uint32_t kLanes>
+class EnvelopeDetector
+{
+    static_assert(kLanes % 4 == 0, "lanes must be padded to a multiple of 4");
+
+public:
+    EnvelopeDetector() noexcept
+        : fDecay(0.f)
+    {
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (uint32_t l = 0; l < kLanes; ++l)
+            fEnvelope[l] = kDynamicsFloor;
+    }
+
+    void setRelease(const float ms, const double sampleRate) noexcept
+    {
+        fDecay = dynamicsCoefficient(ms, sampleRate);
+    }
+
+   /**
+      Follow @a frames interleaved frames, writing the linear envelope of each sample to @a envelope.
+    */
+    void process(const float* const __restrict data, const uint32_t frames, float* const __restrict envelope) noexcept
+    {
+        const Float4 decay = Float4::broadcast(fDecay);
+        const Float4 floor = Float4::broadcast(kDynamicsFloor);
+
+        for (uint32_t l = 0; l < kLanes; l += 4)
+        {
+            Float4 env = Float4::load(fEnvelope + l);
+
+            for (uint32_t i = 0; i < frames; ++i)
+            {
+                env = simd::max(simd::max(simd::abs(Float4::load(data + i * kLanes + l)), env * decay), floor);
+                env.store(envelope + i * kLanes + l);
+            }
+
+            env.store(fEnvelope + l);
+        }
+    }
+
+   /**
+      Follow @a frames interleaved frames, only keeping track of the envelope range per lane.
+      Used by stages to check whether a whole block can take a fast path.
+    */
+    void scan(const float* const __restrict data, const uint32_t frames,
+              float* const __restrict envMin, float* const __restrict envMax) noexcept
+    {
+        const Float4 decay = Float4::broadcast(fDecay);
+        const Float4 floor = Float4::broadcast(kDynamicsFloor);
+
+        for (uint32_t l = 0; l < kLanes; l += 4)
+        {
+            Float4 env = Float4::load(fEnvelope + l);
+            Float4 lo = Float4::broadcast(1e30f);
+            Float4 hi = Float4::broadcast(0.f);
+
+            for (uint32_t i = 0; i < frames; ++i)
+            {
+                env = simd::max(simd::max(simd::abs(Float4::load(data + i * kLanes + l)), env * decay), floor);
+                lo = simd::min(lo, env);
+                hi = simd::max(hi, env);
+            }
+
+            env.store(fEnvelope + l);
+            lo.store(envMin + l);
+            hi.store(envMax + l);
+        }
+    }
+
+   /**
+      Save and restore the detector memory, used by stages that speculatively scan a block.
+    */
+    void save(float* const state) const noexcept
+    {
+        std::memcpy(state, fEnvelope, sizeof(fEnvelope));
+    }
+
+    void restore(const float* const state) noexcept
+    {
+        std::memcpy(fEnvelope, state, sizeof(fEnvelope));
+    }
+
+private:
+    float fEnvelope[kLanes];
+    float fDecay;
+
+    DISTRHO_DECLARE_NON_COPYABLE(EnvelopeDetector)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Precomputed static curve of a dynamics gain computer, indexed by level in log2 units (1 unit = 6.02 dB).
+
+   The table spans -120 dB to +24 dB at 8 points per octave (0.75 dB) with linear interpolation,
+   and levels outside of that range are clamped, so lookups are branch-free.
+ */
+class DynamicsTable
+{
+public:
+    static constexpr const uint32_t kPointsPerOctave = 8;
+    static constexpr const uint32_t kSize
+        = static_cast<uint32_t>(kDynamicsMaxLog2 - kDynamicsMinLog2) * kPointsPerOctave + 1;
+
+    DynamicsTable() noexcept
+    {
+        std::memset(fTable, 0, sizeof(fTable));
+    }
+
+   /**
+      Fill the table from @a curve, a function taking a level in dB and returning the table value.
+    */
+    template <typename Curve>
+    void build(Curve curve) noexcept
+    {
+        for (uint32_t i = 0; i < kSize; ++i)
+            fTable[i] = curve((kDynamicsMinLog2 + static_cast<float>(i) / kPointsPerOctave) * FastMath::kLog2ToDB);
+
+        // guard point so the interpolation at the top end never reads past the table
+        fTable[kSize] = fTable[kSize - 1];
+    }
+
+    inline float lookup(const float levelLog2) const noexcept
+    {
+        const float pos = (std::max(kDynamicsMinLog2, std::min(kDynamicsMaxLog2, levelLog2)) - kDynamicsMinLog2)
+                        * kPointsPerOctave;
+        const int32_t index = static_cast<int32_t>(pos);
+        const float frac = pos - static_cast<float>(index);
+
+        return fTable[index] + (fTable[index + 1] - fTable[index]) * frac;
+    }
+
+   /**
+      Convert @a count linear envelope values to table values in place, @a count must be a multiple of 4.
+    */
+    void lookupEnvelope(float* const values, const uint32_t count) const noexcept
+    {
+        for (uint32_t i = 0; i < count; i += 4)
+            simd::log2(Float4::load(values + i)).store(values + i);
+
+        for (uint32_t i = 0; i < count; ++i)
+            values[i] = lookup(values[i]);
+    }
+
+private:
+    float fTable[kSize + 1];
+
+    DISTRHO_DECLARE_NON_COPYABLE(DynamicsTable)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Noise gate / downward expander for @a kChannels channels, processed as interleaved frames of @a kLanes samples.
+
+   The gate opens above the threshold and only closes again once the level falls below threshold minus hysteresis
+   and the hold time has passed. While closed, levels are expanded downward by the ratio, limited by the range.
+   All per-sample decisions are selects rather than branches so the lane loops vectorize.
+
+   A gate that stays fully open (or fully closed at its range floor) for a whole block takes a fast path
+   that only runs the envelope follower.
+ */
+template <uint32_t kChannels, uint32_t kLanes>
+class NoiseGate
+{
+public:
+    NoiseGate() noexcept
+        : fEnabled(false),
+          fOpenLevel(0.f),
+          fCloseLevel(0.f),
+          fFloorLevel(0.f),
+          fFloorGain(1.f),
+          fHoldSamples(0.f),
+          fAttackCoef(0.f),
+          fReleaseCoef(0.f)
+    {
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        fDetector.reset();
+
+        for (uint32_t l = 0; l < kLanes; ++l)
+        {
+            fOpen[l] = 1.f;
+            fHold[l] = 0.f;
+            fGain[l] = 1.f;
+            fMinGain[l] = 1.f;
+        }
+    }
+
+   /**
+      Update the gate settings.
+      This rebuilds the gain table, so it should only be called when parameters change.
+    */
+    void setup(const float thresholdDB, const float ratio, const float rangeDB, const float hysteresisDB,
+               const float holdMs, const float attackMs, const float releaseMs,
+               const bool enabled, const double sampleRate) noexcept
+    {
+        fEnabled = enabled;
+        fOpenLevel = FastMath::dbToGain(thresholdDB);
+        fCloseLevel = FastMath::dbToGain(thresholdDB - hysteresisDB);
+        fFloorLevel = FastMath::dbToGain(thresholdDB - rangeDB / std::max(ratio - 1.f, 0.01f));
+        fFloorGain = FastMath::dbToGain(-rangeDB);
+        fHoldSamples = static_cast<float>(holdMs * 0.001 * sampleRate);
+        fAttackCoef = dynamicsCoefficient(attackMs, sampleRate);
+        fReleaseCoef = dynamicsCoefficient(releaseMs, sampleRate);
+
+        // short detector release so the envelope tracks the signal, the gate ballistics do the rest
+        fDetector.setRelease(5.f, sampleRate);
+
+        fTable.build([=](const float levelDB) {
+            return FastMath::dbToGain(std::max(-rangeDB, std::min(0.f, (levelDB - thresholdDB) * (ratio - 1.f))));
+        });
+    }
+
+    bool isEnabled() const noexcept
+    {
+        return fEnabled;
+    }
+
+   /**
+      Gate @a frames interleaved frames in place.
+    */
+    void process(float* const data, const uint32_t frames) noexcept
+    {
+        if (processFastPath(data, frames))
+            return;
+
+        float envelope[kDynamicsChunkSize * kLanes];
+        float target[kDynamicsChunkSize * kLanes];
+
+        const Float4 zero = Float4::broadcast(0.f);
+        const Float4 one = Float4::broadcast(1.f);
+        const Float4 snap = Float4::broadcast(1e-5f);
+        const Float4 openLevel = Float4::broadcast(fOpenLevel);
+        const Float4 closeLevel = Float4::broadcast(fCloseLevel);
+        const Float4 holdSamples = Float4::broadcast(fHoldSamples);
+        const Float4 attackCoef = Float4::broadcast(fAttackCoef);
+        const Float4 releaseCoef = Float4::broadcast(fReleaseCoef);
+
+        for (uint32_t offset = 0; offset < frames; offset += kDynamicsChunkSize)
+        {
+            const uint32_t chunk = std::min(kDynamicsChunkSize, frames - offset);
+            float* const __restrict x = data + offset * kLanes;
+
+            fDetector.process(x, chunk, envelope);
+
+            std::memcpy(target, envelope, sizeof(float) * chunk * kLanes);
+            fTable.lookupEnvelope(target, chunk * kLanes);
+
+            for (uint32_t l = 0; l < kLanes; l += 4)
+            {
+                Float4 open = Float4::load(fOpen + l);
+                Float4 hold = Float4::load(fHold + l);
+                Float4 gain = Float4::load(fGain + l);
+                Float4 minGain = Float4::load(fMinGain + l);
+
+                for (uint32_t i = 0; i < chunk; ++i)
+                {
+                    const Float4 env = Float4::load(envelope + i * kLanes + l);
+                    const Float4 above = select(greaterThan(env, openLevel), one, zero);
+                    const Float4 stay = select(greaterThan(env, closeLevel), open, zero);
+                    open = simd::max(above, stay);
+                    hold = select(greaterThan(open, zero), holdSamples, simd::max(hold - one, zero));
+
+                    const Float4 t = select(greaterThan(hold, zero), one, Float4::load(target + i * kLanes + l));
+                    const Float4 coef = select(greaterThan(t, gain), attackCoef, releaseCoef);
+                    const Float4 g = t + (gain - t) * coef;
+
+                    // snap to the target once close enough, rounding can otherwise stall a few ulps away
+                    gain = select(lessThan(simd::abs(g - t), snap), t, g);
+                    minGain = simd::min(minGain, gain);
+
+                    (Float4::load(x + i * kLanes + l) * gain).store(x + i * kLanes + l);
+                }
+
+                open.store(fOpen + l);
+                hold.store(fHold + l);
+                gain.store(fGain + l);
+                minGain.store(fMinGain + l);
+            }
+        }
+    }
+
+   /**
+      Largest gain reduction of any channel since the last call, in positive dB.
+    */
+    float takeGainReductionDB() noexcept
+    {
+        float gain = 1.f;
+
+        for (uint32_t c = 0; c < kChannels; ++c)
+        {
+            gain = std::min(gain, fMinGain[c]);
+            fMinGain[c] = fGain[c];
+        }
+
+        return 0.f - FastMath::gainToDB(std::max(gain, kDynamicsFloor));
+    }
+
+private:
+   /**
+      Scan the block with the envelope follower only.
+      Returns true if the gate state is constant across the block and the audio was handled,
+      otherwise the detector is rewound and the caller takes the full path.
+    */
+    bool processFastPath(float* const data, const uint32_t frames) noexcept
+    {
+        float saved[kLanes], envMin[kLanes], envMax[kLanes];
+        fDetector.save(saved);
+        fDetector.scan(data, frames, envMin, envMax);
+
+        bool allOpen = true, allClosed = true;
+
+        for (uint32_t c = 0; c < kChannels; ++c)
+        {
+            allOpen = allOpen && fOpen[c] > 0.f && fGain[c] == 1.f && envMin[c] > fCloseLevel;
+
+            allClosed = allClosed && fOpen[c] == 0.f && fHold[c] == 0.f && fGain[c] == fFloorGain
+                     && envMax[c] < std::min(fFloorLevel, fOpenLevel);
+        }
+
+        if (allOpen)
+        {
+            // stays open, audio passes untouched
+            for (uint32_t l = 0; l < kLanes; ++l)
+                fHold[l] = fHoldSamples;
+            return true;
+        }
+
+        if (allClosed)
+        {
+            // stays at the range floor, constant gain
+            for (uint32_t i = 0; i < frames * kLanes; ++i)
+                data[i] *= fFloorGain;
+            for (uint32_t c = 0; c < kChannels; ++c)
+                fMinGain[c] = fFloorGain;
+            return true;
+        }
+
+        fDetector.restore(saved);
+        return false;
+    }
+
+    EnvelopeDetector<kLanes> fDetector;
+    DynamicsTable fTable;
+
+    bool fEnabled;
+
+    // thresholds as linear envelope values
+    float fOpenLevel, fCloseLevel, fFloorLevel;
+    float fFloorGain;
+    float fHoldSamples;
+    float fAttackCoef, fReleaseCoef;
+
+    float fOpen[kLanes];
+    float fHold[kLanes];
+    float fGain[kLanes];
+    float fMinGain[kLanes];
+
+    DISTRHO_DECLARE_NON_COPYABLE(NoiseGate)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Feed-forward compressor for @a kChannels channels, processed as interleaved frames of @a kLanes samples.
+
+   The static curve (threshold, ratio, soft knee) lives in a DynamicsTable in log2 units,
+   attack and release smooth the gain reduction in that same domain, and FastMath::exp2 turns it back to linear gain.
+   With stereo link enabled all channels follow the loudest one.
+
+   A block that stays below the knee with no gain reduction left only runs the envelope follower and makeup gain.
+ */
+template <uint32_t kChannels, uint32_t kLanes>
+class Compressor
+{
+public:
+    Compressor() noexcept
+        : fEnabled(false),
+          fLinked(true),
+          fKneeStart(0.f),
+          fMakeup(0.f),
+          fAttackCoef(0.f),
+          fReleaseCoef(0.f)
+    {
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        fDetector.reset();
+
+        for (uint32_t l = 0; l < kLanes; ++l)
+        {
+            fReduction[l] = 0.f;
+            fMaxReduction[l] = 0.f;
+        }
+    }
+
+   /**
+      Update the compressor settings.
+      This rebuilds the gain table, so it should only be called when parameters change.
+    */
+    void setup(const float thresholdDB, const float ratio, const float kneeDB,
+               const float attackMs, const float releaseMs, const float makeupDB,
+               const bool linked, const bool enabled, const double sampleRate) noexcept
+    {
+        fEnabled = enabled;
+        fLinked = linked;
+        fKneeStart = FastMath::dbToGain(thresholdDB - kneeDB * 0.5f);
+        fMakeup = makeupDB / FastMath::kLog2ToDB;
+        fAttackCoef = dynamicsCoefficient(attackMs, sampleRate);
+        fReleaseCoef = dynamicsCoefficient(releaseMs, sampleRate);
+
+        // peak detector with a short release, program-dependent smoothing comes from the compressor ballistics
+        fDetector.setRelease(10.f, sampleRate);
+
+        const float slope = 1.f / ratio - 1.f;
+
+        fTable.build([=](const float levelDB) {
+            const float over = levelDB - thresholdDB;
+            float reductionDB;
+
+            if (2.f * over <= -kneeDB)
+                reductionDB = 0.f;
+            else if (2.f * over < kneeDB)
+                reductionDB = slope * (over + kneeDB * 0.5f) * (over + kneeDB * 0.5f) / (2.f * kneeDB);
+            else
+                reductionDB = slope * over;
+
+            return reductionDB / FastMath::kLog2ToDB;
+        });
+    }
+
+    bool isEnabled() const noexcept
+    {
+        return fEnabled;
+    }
+
+   /**
+      Compress @a frames interleaved frames in place.
+    */
+    void process(float* const data, const uint32_t frames) noexcept
+    {
+        if (processFastPath(data, frames))
+            return;
+
+        float target[kDynamicsChunkSize * kLanes];
+
+        const Float4 zero = Float4::broadcast(0.f);
+        const Float4 snap = Float4::broadcast(-1e-6f);
+        const Float4 makeup = Float4::broadcast(fMakeup);
+        const Float4 attackCoef = Float4::broadcast(fAttackCoef);
+        const Float4 releaseCoef = Float4::broadcast(fReleaseCoef);
+
+        for (uint32_t offset = 0; offset < frames; offset += kDynamicsChunkSize)
+        {
+            const uint32_t chunk = std::min(kDynamicsChunkSize, frames - offset);
+            float* const __restrict x = data + offset * kLanes;
+
+            fDetector.process(x, chunk, target);
+
+            if (fLinked)
+            {
+                for (uint32_t i = 0; i < chunk; ++i)
+                {
+                    float* const frame = target + i * kLanes;
+                    float loudest = frame[0];
+
+                    for (uint32_t c = 1; c < kChannels; ++c)
+                        loudest = std::max(loudest, frame[c]);
+                    for (uint32_t l = 0; l < kLanes; ++l)
+                        frame[l] = loudest;
+                }
+            }
+
+            fTable.lookupEnvelope(target, chunk * kLanes);
+
+            // ballistics, turning the static curve into the smoothed gain reduction per sample
+            for (uint32_t l = 0; l < kLanes; l += 4)
+            {
+                Float4 reduction = Float4::load(fReduction + l);
+                Float4 maxReduction = Float4::load(fMaxReduction + l);
+
+                for (uint32_t i = 0; i < chunk; ++i)
+                {
+                    const Float4 t = Float4::load(target + i * kLanes + l);
+                    const Float4 coef = select(lessThan(t, reduction), attackCoef, releaseCoef);
+                    const Float4 r = t + (reduction - t) * coef;
+
+                    // snap to zero when fully released, instead of decaying into denormals
+                    reduction = select(greaterThan(r, snap), zero, r);
+                    maxReduction = simd::min(maxReduction, reduction);
+                    (reduction + makeup).store(target + i * kLanes + l);
+                }
+
+                reduction.store(fReduction + l);
+                maxReduction.store(fMaxReduction + l);
+            }
+
+            for (uint32_t i = 0; i < chunk * kLanes; i += 4)
+                (Float4::load(x + i) * simd::exp2(Float4::load(target + i))).store(x + i);
+        }
+    }
+
+   /**
+      Largest gain reduction of any channel since the last call, in positive dB.
+    */
+    float takeGainReductionDB() noexcept
+    {
+        float reduction = 0.f;
+
+        for (uint32_t c = 0; c < kChannels; ++c)
+        {
+            reduction = std::min(reduction, fMaxReduction[c]);
+            fMaxReduction[c] = fReduction[c];
+        }
+
+        return 0.f - reduction * FastMath::kLog2ToDB;
+    }
+
+private:
+   /**
+      Scan the block with the envelope follower only.
+      Returns true if no channel reaches the knee and there is no gain reduction left to release,
+      in which case only makeup gain is applied; otherwise the detector is rewound for the full path.
+    */
+    bool processFastPath(float* const data, const uint32_t frames) noexcept
+    {
+        float saved[kLanes], envMin[kLanes], envMax[kLanes];
+        fDetector.save(saved);
+        fDetector.scan(data, frames, envMin, envMax);
+
+        bool idle = true;
+
+        for (uint32_t c = 0; c < kChannels; ++c)
+            idle = idle && fReduction[c] == 0.f && envMax[c] < fKneeStart;
+
+        if (! idle)
+        {
+            fDetector.restore(saved);
+            return false;
+        }
+
+        if (fMakeup != 0.f)
+        {
+            const float makeup = FastMath::exp2(fMakeup);
+
+            for (uint32_t i = 0; i < frames * kLanes; ++i)
+                data[i] *= makeup;
+        }
+
+        return true;
+    }
+
+    EnvelopeDetector<kLanes> fDetector;
+    DynamicsTable fTable;
+
+    bool fEnabled;
+    bool fLinked;
+
+    // linear envelope value where the knee starts, below it the compressor is idle
+    float fKneeStart;
+
+    // makeup gain in log2 units
+    float fMakeup;
+    float fAttackCoef, fReleaseCoef;
+
+    // gain reduction in log2 units, zero or negative
+    float fReduction[kLanes];
+    float fMaxReduction[kLanes];
+
+    DISTRHO_DECLARE_NON_COPYABLE(Compressor)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // DYNAMICS_HPP_INCLUDED
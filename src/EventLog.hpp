@@ -0,0 +1,208 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef EVENT_LOG_HPP_INCLUDED
+#define EVENT_LOG_HPP_INCLUDED
+
+#include "FastMath.hpp"
+
+#include <atomic>
+#include <chrono>
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Events that can be logged, each one with up to 2 numeric arguments for its format string.
+   New events must be appended before kEventCount.
+ */
+enum EventCode {
+    kEventActivated = 0,
+    kEventDeactivated,
+    kEventLatencyChanged,
+    kEventSilenceStarted,
+    kEventSilenceEnded,
+    kEventBlockSplit,
+    kEventGateOn,
+    kEventGateOff,
+    kEventCompressorOn,
+    kEventCompressorOff,
+    kEventOscListening,
+    kEventOscFailed,
+    kEventInputNotFinite,
+    kEventInputFinite,
+    kEventParameterNotFinite,
+    kEventCount
+};
+
+static const char* const kEventFormats[kEventCount] = {
+    "activated at %.0f Hz, buffer size %.0f",
+    "deactivated",
+    "latency is now %.0f samples",
+    "input silent, processing paused",
+    "input resumed, processing restarted",
+    "host block of %.0f frames is over the announced buffer size of %.0f",
+    "gate on",
+    "gate off",
+    "compressor on",
+    "compressor off",
+    "OSC server listening on port %.0f",
+    "OSC server failed to listen on port %.0f",
+    "non-finite input samples on channel %.0f, replaced with silence",
+    "input finite again, after %.0f blocks with non-finite samples",
+    "non-finite value for parameter %.0f ignored",
+};
+
+/**
+   A logged event, formatting happens only when it is displayed.
+ */
+struct EventRecord {
+    uint64_t time; // steady clock, in nanoseconds
+    uint32_t source;
+    uint32_t code;
+    float args[2];
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Process-wide ring of event records, written by any thread and read by plugin editors.
+
+   Writers claim a slot with a single atomic increment and never wait, so logging is fine on the audio thread.
+   Each slot carries the index it was written for, so readers detect records still being written (and wait for them)
+   as well as records that were overwritten before they could be read (and skip them).
+   Once the ring is full the oldest records are lost.
+ */
+class EventLog
+{
+public:
+    static constexpr const uint32_t kSize = 4096;
+
+    static EventLog& getInstance() noexcept
+    {
+        static EventLog log;
+        return log;
+    }
+
+   /**
+      A new source id, to tell apart the records of different plugin instances.
+    */
+    static uint32_t newSource() noexcept
+    {
+        static std::atomic<uint32_t> counter(0);
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+   /**
+      Log an event, from any thread.
+    */
+    void write(const uint32_t source, const EventCode code, const float arg0 = 0.f, const float arg1 = 0.f) noexcept
+    {
+        const uint64_t time = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+
+        const uint64_t index = fWriteIndex.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot(fSlots[index & (kSize - 1)]);
+
+        // 0 marks the slot as busy
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.time.store(time, std::memory_order_relaxed);
+        slot.source.store(source, std::memory_order_relaxed);
+        slot.code.store(static_cast<uint32_t>(code), std::memory_order_relaxed);
+        slot.args[0].store(static_cast<uint32_t>(FastMath::floatToBits(arg0)), std::memory_order_relaxed);
+        slot.args[1].store(static_cast<uint32_t>(FastMath::floatToBits(arg1)), std::memory_order_relaxed);
+
+        slot.sequence.store(index + 1, std::memory_order_release);
+    }
+
+   /**
+      Copy up to @a maxCount records written since @a cursor into @a records, and move the cursor past them.
+      Returns the number of records copied, and adds the number of records that were lost to @a lost.
+    */
+    uint32_t read(uint64_t& cursor, EventRecord* const records, const uint32_t maxCount, uint64_t& lost) const noexcept
+    {
+        const uint64_t end = fWriteIndex.load(std::memory_order_acquire);
+        uint32_t count = 0;
+
+        if (end - cursor > kSize)
+        {
+            lost += end - cursor - kSize;
+            cursor = end - kSize;
+        }
+
+        for (; cursor < end && count < maxCount; ++cursor)
+        {
+            const Slot& slot(fSlots[cursor & (kSize - 1)]);
+            const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+            // still being written, try again next time
+            if (sequence < cursor + 1)
+                break;
+
+            EventRecord& record(records[count]);
+            record.time = slot.time.load(std::memory_order_relaxed);
+            record.source = slot.source.load(std::memory_order_relaxed);
+            record.code = slot.code.load(std::memory_order_relaxed);
+            record.args[0] = FastMath::bitsToFloat(static_cast<int32_t>(slot.args[0].load(std::memory_order_relaxed)));
+            record.args[1] = FastMath::bitsToFloat(static_cast<int32_t>(slot.args[1].load(std::memory_order_relaxed)));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // overwritten by a newer record, before or while reading it
+            if (sequence != cursor + 1 || slot.sequence.load(std::memory_order_relaxed) != sequence)
+            {
+                ++lost;
+                continue;
+            }
+
+            ++count;
+        }
+
+        return count;
+    }
+
+   /**
+      Format the message of @a record into @a buffer.
+    */
+    static void format(const EventRecord& record, char* const buffer, const std::size_t size) noexcept
+    {
+        if (record.code < kEventCount)
+            std::snprintf(buffer, size, kEventFormats[record.code], record.args[0], record.args[1]);
+        else
+            std::snprintf(buffer, size, "unknown event %u", record.code);
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence; // index + 1 of the record in this slot, 0 while it is being written
+        std::atomic<uint64_t> time;
+        std::atomic<uint32_t> source;
+        std::atomic<uint32_t> code;
+        std::atomic<uint32_t> args[2]; // float bits
+    };
+
+    std::atomic<uint64_t> fWriteIndex;
+    Slot fSlots[kSize];
+
+    EventLog() noexcept
+        : fWriteIndex(0)
+    {
+        for (uint32_t i = 0; i < kSize; ++i)
+            fSlots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(EventLog)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // EVENT_LOG_HPP_INCLUDED
@@ -0,0 +1,151 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef FAST_MATH_HPP_INCLUDED
+#define FAST_MATH_HPP_INCLUDED
+
+#include "DistrhoUtils.hpp"
+
+#include <cstring>
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+// Branch-free approximations of the transcendental functions used by the DSP.
+// All of them are plain inline functions without lookups, so loops calling them can be auto-vectorized.
+// The error bounds below are measured against the double precision std:: functions by the biquad benchmark.
+
+namespace FastMath {
+
+static constexpr const float kPi = 3.14159265358979323846f;
+static constexpr const float kTwoPi = 6.28318530717958647692f;
+static constexpr const float kHalfPi = 1.57079632679489661923f;
+
+// log2(10) / 20 and its inverse, for dB <-> linear conversions
+static constexpr const float kDBToLog2 = 0.166096404744368117393f;
+static constexpr const float kLog2ToDB = 6.02059991327962390427f;
+
+static inline float bitsToFloat(const int32_t i) noexcept
+{
+    float f;
+    std::memcpy(&f, &i, sizeof(f));
+    return f;
+}
+
+static inline int32_t floatToBits(const float f) noexcept
+{
+    int32_t i;
+    std::memcpy(&i, &f, sizeof(i));
+    return i;
+}
+
+/**
+   Whether @a f is neither an infinity nor a NaN.
+   Tested on the exponent bits, so unlike std::isfinite() this keeps working with -ffast-math.
+ */
+static inline bool isFinite(const float f) noexcept
+{
+    return (floatToBits(f) & 0x7f800000) != 0x7f800000;
+}
+
+/**
+   2^x, valid for x in [-126, 126].
+   Maximum relative error: 1.6e-7.
+ */
+static inline float exp2(float x) noexcept
+{
+    x = std::max(-126.f, std::min(126.f, x));
+
+    // floor without a libm call, so this vectorizes on plain SSE2
+    const int32_t it = static_cast<int32_t>(x);
+    const int32_t i = it - (static_cast<float>(it) > x ? 1 : 0);
+    const float f = x - static_cast<float>(i);
+
+    // minimax polynomial for 2^f over [0, 1)
+    const float p = 1.0f + f * (0.693151363f
+                         + f * (0.240164154f
+                         + f * (0.0558004468f
+                         + f * (0.00901668795f
+                         + f * 0.00186718273f))));
+
+    return p * bitsToFloat((i + 127) << 23);
+}
+
+/**
+   log2(x), valid for positive normal x.
+   Maximum absolute error: 2.0e-7 for x in [0.5, 2], 1.1e-6 over the whole range (result rounding).
+ */
+static inline float log2(const float x) noexcept
+{
+    const int32_t bits = floatToBits(x);
+    const float e = static_cast<float>(((bits >> 23) & 0xff) - 127);
+
+    // mantissa in [1, 2), remapped to [sqrt(1/2), sqrt(2)) so the series converges quickly
+    float m = bitsToFloat((bits & 0x007fffff) | 0x3f800000);
+    const float adjust = m > 1.41421356f ? 1.0f : 0.0f;
+    m *= 1.0f - 0.5f * adjust;
+
+    // log2(m) = 2/ln(2) * atanh((m-1)/(m+1))
+    const float t = (m - 1.0f) / (m + 1.0f);
+    const float t2 = t * t;
+    const float s = t * (2.88539008f
+                  + t2 * (0.961796694f
+                  + t2 * (0.577078016f
+                  + t2 * (0.412198583f
+                  + t2 * 0.320598979f))));
+
+    return e + adjust + s;
+}
+
+/**
+   sin(x) for x in [-pi/2, pi/2].
+   Maximum absolute error: 2.1e-7.
+ */
+static inline float sinHalfPi(const float x) noexcept
+{
+    const float x2 = x * x;
+    return x * (1.0f
+         + x2 * (-0.166666667f
+         + x2 * (0.00833333333f
+         + x2 * (-0.000198412698f
+         + x2 * (2.75573192e-6f
+         + x2 * -2.50521084e-8f)))));
+}
+
+/**
+   sin(x) and cos(x) for x in [0, pi], as needed for filter design (w0 = 2pi * f / fs).
+   Maximum absolute error: 2.1e-7 on both outputs.
+ */
+static inline void sinCos(const float x, float& s, float& c) noexcept
+{
+    s = sinHalfPi(kHalfPi - std::abs(x - kHalfPi));
+    c = sinHalfPi(kHalfPi - x);
+}
+
+/**
+   Decibels to linear gain.
+ */
+static inline float dbToGain(const float db) noexcept
+{
+    return exp2(db * kDBToLog2);
+}
+
+/**
+   Linear gain to decibels, valid for positive normal values.
+ */
+static inline float gainToDB(const float gain) noexcept
+{
+    return log2(gain) * kLog2ToDB;
+}
+
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // FAST_MATH_HPP_INCLUDED
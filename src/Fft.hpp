@@ -0,0 +1,121 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef FFT_HPP_INCLUDED
+#define FFT_HPP_INCLUDED
+
+#include "DistrhoUtils.hpp"
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   In-place radix-2 complex FFT, for analysis displays on the editor side.
+
+   Bit reversal and twiddle tables are built by setup(), so transform() does not allocate.
+   Nothing here is meant for the audio thread.
+ */
+class Fft
+{
+public:
+    Fft() noexcept
+        : fSize(0) {}
+
+   /**
+      Prepare for transforms of @a size points, a power of 2.
+    */
+    void setup(const uint32_t size)
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(size >= 2 && (size & (size - 1)) == 0,);
+
+        fSize = size;
+        fReverse.resize(size);
+        fCos.resize(size / 2);
+        fSin.resize(size / 2);
+
+        uint32_t bits = 0;
+        while ((1u << bits) < size)
+            ++bits;
+
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            uint32_t reversed = 0;
+
+            for (uint32_t b = 0; b < bits; ++b)
+                reversed |= ((i >> b) & 1) << (bits - 1 - b);
+
+            fReverse[i] = reversed;
+        }
+
+        for (uint32_t i = 0; i < size / 2; ++i)
+        {
+            const double phase = -2.0 * M_PI * i / size;
+            fCos[i] = static_cast<float>(std::cos(phase));
+            fSin[i] = static_cast<float>(std::sin(phase));
+        }
+    }
+
+    uint32_t getSize() const noexcept
+    {
+        return fSize;
+    }
+
+   /**
+      Forward transform of the getSize() points in @a re and @a im, unscaled.
+    */
+    void transform(float* const re, float* const im) const noexcept
+    {
+        for (uint32_t i = 0; i < fSize; ++i)
+        {
+            const uint32_t j = fReverse[i];
+
+            if (j > i)
+            {
+                std::swap(re[i], re[j]);
+                std::swap(im[i], im[j]);
+            }
+        }
+
+        for (uint32_t half = 1, step = fSize / 2; half < fSize; half *= 2, step /= 2)
+        {
+            for (uint32_t start = 0; start < fSize; start += 2 * half)
+            {
+                for (uint32_t k = 0; k < half; ++k)
+                {
+                    const float wr = fCos[k * step];
+                    const float wi = fSin[k * step];
+                    const uint32_t a = start + k;
+                    const uint32_t b = a + half;
+
+                    const float tr = re[b] * wr - im[b] * wi;
+                    const float ti = re[b] * wi + im[b] * wr;
+
+                    re[b] = re[a] - tr;
+                    im[b] = im[a] - ti;
+                    re[a] += tr;
+                    im[a] += ti;
+                }
+            }
+        }
+    }
+
+private:
+    uint32_t fSize;
+    std::vector<uint32_t> fReverse;
+    std::vector<float> fCos, fSin;
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // FFT_HPP_INCLUDED
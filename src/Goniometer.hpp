@@ -0,0 +1,176 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef GONIOMETER_HPP_INCLUDED
+#define GONIOMETER_HPP_INCLUDED
+
+#include "OpenGL.hpp"
+#include "ScopeFeed.hpp"
+
+#include <cmath>
+#include <cstring>
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Goniometer (Lissajous) display for the editor, mid on the vertical axis and side on the horizontal one.
+
+   Points are not drawn as ImGui primitives. They are splatted into a persistence buffer that fades with time,
+   like the phosphor of an analog scope, and the buffer goes to the GPU as a single texture drawn with one image quad.
+   Each frame costs one pass over the fixed size buffer plus the points received, and as the audio side sends a fixed
+   number of points per second (see ScopeFeed), that does not depend on the sample rate.
+
+   All methods must be called from the editor thread, with its OpenGL context current.
+ */
+class GoniometerView
+{
+public:
+    static constexpr const int kSize = 256;
+
+    // seconds for a trace to fade to 1/e, and how bright a single point starts
+    static constexpr const float kPersistence = 0.25f;
+    static constexpr const float kPointEnergy = 0.35f;
+
+    GoniometerView() noexcept
+        : fTexture(0)
+    {
+        clear();
+    }
+
+    ~GoniometerView()
+    {
+        if (fTexture != 0)
+            glDeleteTextures(1, &fTexture);
+    }
+
+    void clear() noexcept
+    {
+        std::memset(fEnergy, 0, sizeof(fEnergy));
+    }
+
+   /**
+      Fade the trace by @a deltaTime seconds, add all points waiting in @a feed and upload the result.
+    */
+    void update(ScopeFeed& feed, const float deltaTime)
+    {
+        const float fade = std::exp(-std::max(0.0f, deltaTime) / kPersistence);
+
+        for (int i = 0; i < kSize * kSize; ++i)
+            fEnergy[i] *= fade;
+
+        ScopePoint points[256];
+
+        while (const uint32_t count = feed.readGoniometer(points, 256))
+        {
+            for (uint32_t i = 0; i < count; ++i)
+                splat(points[i]);
+        }
+
+        upload();
+    }
+
+   /**
+      Draw the trace as a @a size pixels wide square, with the L, R, mid and side axes on top.
+    */
+    void draw(const float size)
+    {
+        if (fTexture == 0)
+            return;
+
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImGui::Image(reinterpret_cast<ImTextureID>(static_cast<intptr_t>(fTexture)), ImVec2(size, size));
+
+        ImDrawList* const drawList = ImGui::GetWindowDrawList();
+        const ImU32 color = IM_COL32(255, 255, 255, 48);
+        const float mid = size * 0.5f;
+
+        drawList->AddLine(ImVec2(origin.x + mid, origin.y), ImVec2(origin.x + mid, origin.y + size), color);
+        drawList->AddLine(ImVec2(origin.x, origin.y + mid), ImVec2(origin.x + size, origin.y + mid), color);
+        drawList->AddLine(origin, ImVec2(origin.x + size, origin.y + size), color);
+        drawList->AddLine(ImVec2(origin.x + size, origin.y), ImVec2(origin.x, origin.y + size), color);
+    }
+
+private:
+   /**
+      Add a point, spread over the 4 nearest cells so slow traces do not look jagged.
+      Both channels at full scale land on the edge of the display.
+    */
+    void splat(const ScopePoint& point) noexcept
+    {
+        const float side = 0.5f * (point.right - point.left);
+        const float mid = 0.5f * (point.left + point.right);
+
+        const float x = (side + 1.0f) * 0.5f * (kSize - 1);
+        const float y = (1.0f - mid) * 0.5f * (kSize - 1);
+
+        // also rejects NaN
+        if (! (x >= 0.0f && x < kSize - 1 && y >= 0.0f && y < kSize - 1))
+            return;
+
+        const int cx = static_cast<int>(x);
+        const int cy = static_cast<int>(y);
+        const float fx = x - cx;
+        const float fy = y - cy;
+        float* const cell = fEnergy + cy * kSize + cx;
+
+        cell[0] += kPointEnergy * (1.0f - fx) * (1.0f - fy);
+        cell[1] += kPointEnergy * fx * (1.0f - fy);
+        cell[kSize] += kPointEnergy * (1.0f - fx) * fy;
+        cell[kSize + 1] += kPointEnergy * fx * fy;
+    }
+
+   /**
+      Tone map the energy into green phosphor pixels and replace the texture contents.
+    */
+    void upload()
+    {
+        for (int i = 0; i < kSize * kSize; ++i)
+        {
+            // saturates smoothly instead of clipping where the trace piles up
+            const float brightness = fEnergy[i] / (1.0f + fEnergy[i]);
+            uint8_t* const pixel = fPixels + i * 4;
+
+            pixel[0] = static_cast<uint8_t>(brightness * 120.0f);
+            pixel[1] = static_cast<uint8_t>(brightness * 255.0f);
+            pixel[2] = static_cast<uint8_t>(brightness * 140.0f);
+            pixel[3] = 255;
+        }
+
+        GLint previous = 0;
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+
+        if (fTexture == 0)
+        {
+            glGenTextures(1, &fTexture);
+            glBindTexture(GL_TEXTURE_2D, fTexture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, kSize, kSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, fPixels);
+        }
+        else
+        {
+            glBindTexture(GL_TEXTURE_2D, fTexture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, kSize, kSize, GL_RGBA, GL_UNSIGNED_BYTE, fPixels);
+        }
+
+        glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(previous));
+    }
+
+    GLuint fTexture;
+    float fEnergy[kSize * kSize];
+    uint8_t fPixels[kSize * kSize * 4];
+
+    DISTRHO_DECLARE_NON_COPYABLE(GoniometerView)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // GONIOMETER_HPP_INCLUDED
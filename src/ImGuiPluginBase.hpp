@@ -0,0 +1,52 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef IMGUI_PLUGIN_BASE_HPP_INCLUDED
+#define IMGUI_PLUGIN_BASE_HPP_INCLUDED
+
+#include "DistrhoPlugin.hpp"
+#include "EventLog.hpp"
+#include "ScopeFeed.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Base class of the plugin, holding what the editor reaches directly: the scope feed and the event log source.@n
+   The editor gets the plugin instance through UI::getPluginInstancePointer(), which points to a Plugin,
+   so it can only rely on this intermediate class and not on the full plugin class in PluginDSP.cpp.
+ */
+class ImGuiPluginBase : public Plugin
+{
+public:
+    ImGuiPluginBase(const uint32_t parameterCount, const uint32_t programCount, const uint32_t stateCount)
+        : Plugin(parameterCount, programCount, stateCount) {}
+
+    ScopeFeed& getScopeFeed() noexcept
+    {
+        return fScopeFeed;
+    }
+
+   /**
+      Source id of the event log records written by this instance.
+    */
+    uint32_t getLogSource() const noexcept
+    {
+        return fLogSource;
+    }
+
+protected:
+    ScopeFeed fScopeFeed;
+    const uint32_t fLogSource = EventLog::newSource();
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // IMGUI_PLUGIN_BASE_HPP_INCLUDED
@@ -0,0 +1,491 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef METER_BRIDGE_HPP_INCLUDED
+#define METER_BRIDGE_HPP_INCLUDED
+
+#include "FastMath.hpp"
+#include "extra/Mutex.hpp"
+
+#include <atomic>
+#include <chrono>
+
+// the table is only shared with the meter bridge application when it is built, see IMGUI_PLUGIN_METER_BRIDGE
+#if defined(IMGUI_PLUGIN_METER_BRIDGE) && ! defined(DISTRHO_OS_WINDOWS)
+# define METER_BRIDGE_SHARED 1
+#else
+# define METER_BRIDGE_SHARED 0
+#endif
+
+#ifndef DISTRHO_OS_WINDOWS
+# include <unistd.h>
+#endif
+
+#if METER_BRIDGE_SHARED
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Values every instance publishes to the meter bridge, once per processed block.
+ */
+enum MeterBridgeValue {
+    kMeterBridgeGain = 0,
+    kMeterBridgeLevelLeft,
+    kMeterBridgeLevelRight,
+    kMeterBridgeGateReduction,
+    kMeterBridgeCompReduction,
+    kMeterBridgeCorrelation,
+    kMeterBridgeValueCount
+};
+
+static constexpr const uint32_t kMeterBridgeSlots = 256;
+static constexpr const uint32_t kMeterBridgeMagic = 0x4d425232; // "MBR2", changes with the table layout
+static constexpr const char* const kMeterBridgeName = "/imgui-demo-plugin-meters";
+
+// seconds without a publish after which a slot counts as abandoned, as by a crashed process
+static constexpr const uint32_t kMeterBridgeTimeout = 5;
+
+/**
+   One instance worth of values, guarded by a sequence lock.
+   The writer makes @a sequence odd while it updates the values, so readers can detect and retry torn reads
+   without the audio thread ever waiting on them.
+
+   Slots are owned through a random token drawn on each open, and kept alive by a heartbeat on the realtime clock.
+   Process ids are not used for that, they collide across PID namespaces (containers, Flatpak) sharing the table.
+ */
+struct MeterBridgeSlot {
+    std::atomic<uint32_t> owner;     // token of the owning instance, 0 when free
+    std::atomic<uint32_t> heartbeat; // realtime clock seconds of the last claim or publish
+    std::atomic<uint32_t> process;   // id of the owning process in its own namespace, only shown by the bridge
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint32_t> values[kMeterBridgeValueCount]; // float bits
+};
+
+/**
+   The shared table, zero-filled memory is a valid empty table.
+ */
+struct MeterBridgeTable {
+    std::atomic<uint32_t> magic;
+    MeterBridgeSlot slots[kMeterBridgeSlots];
+};
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "meter bridge atomics must be lock-free to work across processes");
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Slot in the process-wide meter table, owned by a single plugin instance.
+
+   By default the table is private to the process, readable from within it (as the OSC server does) but not from
+   outside. Built with IMGUI_PLUGIN_METER_BRIDGE on a POSIX system, the table lives in named shared memory instead,
+   so the meter bridge application can read the values of every instance in every process.
+
+   The last instance to leave the shared table removes its name, so nothing is left behind once no plugin runs.
+   A process keeps its mapping while any of its instances holds a slot, and checks on each open that the mapping is
+   still the one behind the name, mapping the new table otherwise.
+
+   open() and close() take care of the slot and are not realtime-safe, publish() is.
+ */
+class MeterBridge
+{
+public:
+    MeterBridge() noexcept
+        : fTable(nullptr),
+          fSlot(nullptr),
+          fToken(0) {}
+
+    ~MeterBridge() noexcept
+    {
+        close();
+    }
+
+   /**
+      Claim a free slot, does nothing if all slots are taken.
+    */
+    void open() noexcept
+    {
+        if (fTable != nullptr)
+            return;
+
+        MeterBridgeTable* const table = acquireTable();
+        DISTRHO_SAFE_ASSERT_RETURN(table != nullptr,);
+
+        const uint32_t token = newToken();
+        const uint32_t now = getSeconds();
+
+        for (uint32_t i = 0; i < kMeterBridgeSlots; ++i)
+        {
+            MeterBridgeSlot& slot(table->slots[i]);
+            uint32_t owner = slot.owner.load(std::memory_order_relaxed);
+
+            // slots of crashed processes are free to take as well
+            if (owner != 0 && isAlive(slot, now))
+                continue;
+
+            if (slot.owner.compare_exchange_strong(owner, token, std::memory_order_acquire))
+            {
+                slot.heartbeat.store(now, std::memory_order_relaxed);
+                slot.process.store(getProcessId(), std::memory_order_relaxed);
+
+                // a previous owner may have died in the middle of an update
+                const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+
+                if (sequence & 1)
+                    slot.sequence.store(sequence + 1, std::memory_order_release);
+
+                fTable = table;
+                fSlot = &slot;
+                fToken = token;
+                return;
+            }
+        }
+
+        releaseTable(table);
+    }
+
+   /**
+      Give the slot back.
+    */
+    void close() noexcept
+    {
+        if (fTable == nullptr)
+            return;
+
+        // the slot is only ours as long as it holds our token
+        uint32_t owner = fToken;
+        fSlot->owner.compare_exchange_strong(owner, 0, std::memory_order_release);
+
+        releaseTable(fTable);
+        fTable = nullptr;
+        fSlot = nullptr;
+        fToken = 0;
+    }
+
+   /**
+      Update all values of this instance at once, from the audio thread.@n
+      Nothing is written once the slot was taken over, which only happens after kMeterBridgeTimeout seconds without
+      any publish; the instance gets a slot again on its next open().
+    */
+    void publish(const float (&values)[kMeterBridgeValueCount]) noexcept
+    {
+        if (fSlot == nullptr || fSlot->owner.load(std::memory_order_relaxed) != fToken)
+            return;
+
+        const uint32_t sequence = fSlot->sequence.load(std::memory_order_relaxed);
+
+        fSlot->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (uint32_t i = 0; i < kMeterBridgeValueCount; ++i)
+            fSlot->values[i].store(static_cast<uint32_t>(FastMath::floatToBits(values[i])), std::memory_order_relaxed);
+
+        fSlot->sequence.store(sequence + 2, std::memory_order_release);
+        fSlot->heartbeat.store(getSeconds(), std::memory_order_relaxed);
+    }
+
+   /**
+      Read back the values last published by this instance, from any thread.
+    */
+    bool readPublished(float (&values)[kMeterBridgeValueCount]) const noexcept
+    {
+        return fSlot != nullptr && fSlot->owner.load(std::memory_order_relaxed) == fToken && readValues(*fSlot, values);
+    }
+
+   /**
+      Read a consistent copy of the values in @a slot, fails if the slot is free, abandoned or keeps changing.
+    */
+    static bool read(const MeterBridgeSlot& slot, float (&values)[kMeterBridgeValueCount]) noexcept
+    {
+        return slot.owner.load(std::memory_order_relaxed) != 0 && isAlive(slot, getSeconds()) && readValues(slot, values);
+    }
+
+   /**
+      Whether any live instance holds a slot of @a table.
+    */
+    static bool hasOwners(const MeterBridgeTable& table) noexcept
+    {
+        const uint32_t now = getSeconds();
+
+        for (uint32_t i = 0; i < kMeterBridgeSlots; ++i)
+        {
+            const MeterBridgeSlot& slot(table.slots[i]);
+
+            if (slot.owner.load(std::memory_order_relaxed) != 0 && isAlive(slot, now))
+                return true;
+        }
+
+        return false;
+    }
+
+   /**
+      Map the shared table without creating it, as done by the meter bridge application.
+      Returns null while no plugin instance has created it yet, or where shared memory is not enabled.
+    */
+    static const MeterBridgeTable* mapSharedTable() noexcept
+    {
+       #if METER_BRIDGE_SHARED
+        const int fd = shm_open(kMeterBridgeName, O_RDWR, 0);
+
+        if (fd < 0)
+            return nullptr;
+
+        MeterBridgeTable* const table = mapTable(fd);
+        ::close(fd);
+        return table;
+       #else
+        return nullptr;
+       #endif
+    }
+
+   /**
+      What a reader polls with, given its current mapping or null: keeps @a table while live instances hold slots in
+      it, otherwise releases it and maps whatever table is behind the name now, as plugins create a new one after the
+      last instance left the previous one.
+    */
+    static const MeterBridgeTable* refreshSharedTable(const MeterBridgeTable* const table) noexcept
+    {
+        if (table != nullptr && hasOwners(*table))
+            return table;
+
+        unmapSharedTable(table);
+        return mapSharedTable();
+    }
+
+   /**
+      Release a table returned by mapSharedTable().
+    */
+    static void unmapSharedTable(const MeterBridgeTable* const table) noexcept
+    {
+       #if METER_BRIDGE_SHARED
+        if (table != nullptr)
+            munmap(const_cast<MeterBridgeTable*>(table), sizeof(MeterBridgeTable));
+       #else
+        // unused
+        (void)table;
+       #endif
+    }
+
+private:
+    MeterBridgeTable* fTable;
+    MeterBridgeSlot* fSlot;
+    uint32_t fToken;
+
+   /**
+      The shared mapping of this process, with the identity of the object behind it and how many instances use it.
+    */
+    struct SharedMapping {
+        Mutex mutex;
+        MeterBridgeTable* table = nullptr;
+        uint64_t device = 0;
+        uint64_t inode = 0;
+        uint32_t users = 0;
+    };
+
+    static SharedMapping& getSharedMapping() noexcept
+    {
+        static SharedMapping mapping;
+        return mapping;
+    }
+
+   /**
+      The table a new slot is claimed in, creating the shared one if needed.@n
+      Falls back to a table private to the process where shared memory is not enabled or not available.
+    */
+    static MeterBridgeTable* acquireTable() noexcept
+    {
+       #if METER_BRIDGE_SHARED
+        SharedMapping& mapping(getSharedMapping());
+        const MutexLocker cml(mapping.mutex);
+
+        const int fd = shm_open(kMeterBridgeName, O_RDWR | O_CREAT, 0600);
+
+        if (fd >= 0)
+        {
+            struct stat st;
+
+            if (fstat(fd, &st) == 0
+                && (mapping.table == nullptr
+                    || mapping.device != static_cast<uint64_t>(st.st_dev)
+                    || mapping.inode != static_cast<uint64_t>(st.st_ino)))
+            {
+                // the name was removed and created again since we mapped it, move over once no slot of ours is left
+                if (mapping.users == 0)
+                {
+                    if (MeterBridgeTable* const table = mapTable(fd))
+                    {
+                        if (mapping.table != nullptr)
+                            munmap(mapping.table, sizeof(MeterBridgeTable));
+
+                        mapping.table = table;
+                        mapping.device = static_cast<uint64_t>(st.st_dev);
+                        mapping.inode = static_cast<uint64_t>(st.st_ino);
+                    }
+                }
+            }
+
+            ::close(fd);
+        }
+
+        if (mapping.table != nullptr)
+        {
+            ++mapping.users;
+            return mapping.table;
+        }
+       #endif
+
+        static MeterBridgeTable localTable;
+        return &localTable;
+    }
+
+   /**
+      Drop a use of @a table, removing the shared name once no live instance of any process holds a slot.@n
+      An instance of another process claiming a slot at that very moment stays invisible to the bridge until it
+      opens again, which then maps the new table.
+    */
+    static void releaseTable(MeterBridgeTable* const table) noexcept
+    {
+       #if METER_BRIDGE_SHARED
+        SharedMapping& mapping(getSharedMapping());
+        const MutexLocker cml(mapping.mutex);
+
+        if (table != mapping.table)
+            return;
+
+        DISTRHO_SAFE_ASSERT_RETURN(mapping.users != 0,);
+
+        if (--mapping.users != 0 || hasOwners(*table))
+            return;
+
+        // only remove the name while it still refers to our table, another process may have created a new one
+        const int fd = shm_open(kMeterBridgeName, O_RDWR, 0);
+
+        if (fd >= 0)
+        {
+            struct stat st;
+
+            if (fstat(fd, &st) == 0
+                && mapping.device == static_cast<uint64_t>(st.st_dev)
+                && mapping.inode == static_cast<uint64_t>(st.st_ino))
+                shm_unlink(kMeterBridgeName);
+
+            ::close(fd);
+        }
+       #else
+        // unused
+        (void)table;
+       #endif
+    }
+
+   #if METER_BRIDGE_SHARED
+    static MeterBridgeTable* mapTable(const int fd) noexcept
+    {
+        void* data = MAP_FAILED;
+
+        // a new object is empty, the size is zero-filled by the kernel
+        if (ftruncate(fd, sizeof(MeterBridgeTable)) == 0)
+            data = mmap(nullptr, sizeof(MeterBridgeTable), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (data == MAP_FAILED)
+            return nullptr;
+
+        MeterBridgeTable* const table = static_cast<MeterBridgeTable*>(data);
+        uint32_t magic = 0;
+
+        if (table->magic.compare_exchange_strong(magic, kMeterBridgeMagic) || magic == kMeterBridgeMagic)
+            return table;
+
+        // left behind by an incompatible build
+        munmap(data, sizeof(MeterBridgeTable));
+        return nullptr;
+    }
+   #endif
+
+    static bool readValues(const MeterBridgeSlot& slot, float (&values)[kMeterBridgeValueCount]) noexcept
+    {
+        for (int attempt = 0; attempt < 8; ++attempt)
+        {
+            const uint32_t before = slot.sequence.load(std::memory_order_acquire);
+
+            if (before & 1)
+                continue;
+
+            for (uint32_t i = 0; i < kMeterBridgeValueCount; ++i)
+                values[i] = FastMath::bitsToFloat(static_cast<int32_t>(slot.values[i].load(std::memory_order_relaxed)));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot.sequence.load(std::memory_order_relaxed) == before)
+                return true;
+        }
+
+        return false;
+    }
+
+   /**
+      Whether the owner of @a slot published recently, a heartbeat ahead of @a now (clock stepped back) counts too.
+    */
+    static bool isAlive(const MeterBridgeSlot& slot, const uint32_t now) noexcept
+    {
+        const uint32_t heartbeat = slot.heartbeat.load(std::memory_order_relaxed);
+        return static_cast<int32_t>(now - heartbeat) <= static_cast<int32_t>(kMeterBridgeTimeout);
+    }
+
+   /**
+      Seconds on the realtime clock, the one clock all processes of the machine agree on whatever their namespaces.
+    */
+    static uint32_t getSeconds() noexcept
+    {
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+   /**
+      A new owner token, never 0.@n
+      Mixes the time, this process, where it got loaded (address space randomization) and a counter,
+      so tokens differ between instances, processes and namespaces.
+    */
+    static uint32_t newToken() noexcept
+    {
+        static std::atomic<uint32_t> counter(0);
+
+        uint64_t x = static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        x ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&counter)) << 16;
+        x ^= static_cast<uint64_t>(getProcessId()) << 40;
+        x += (counter.fetch_add(1, std::memory_order_relaxed) + 1) * UINT64_C(0x9e3779b97f4a7c15);
+
+        // splitmix64 finalizer
+        x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+        x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+        x ^= x >> 31;
+
+        const uint32_t token = static_cast<uint32_t>(x ^ (x >> 32));
+        return token != 0 ? token : 1;
+    }
+
+    static uint32_t getProcessId() noexcept
+    {
+       #ifndef DISTRHO_OS_WINDOWS
+        return static_cast<uint32_t>(getpid());
+       #else
+        return 1;
+       #endif
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(MeterBridge)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // METER_BRIDGE_HPP_INCLUDED
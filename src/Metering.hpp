@@ -0,0 +1,461 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef METERING_HPP_INCLUDED
+#define METERING_HPP_INCLUDED
+
+#include "Simd.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+// mean power of -120 dB, meters read as silent below it
+static constexpr const float kMeterSilence = 1e-12f;
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Phase correlation and L/R balance of a stereo pair.
+
+   The audio path only accumulates the raw sums L*R, L*L and R*R of each block, inside a pass that already touches
+   every sample (see accumulate()). Exponential integration then runs once per block on those three sums,
+   with a coefficient derived from the block length, so the readings do not depend on the host buffer size.
+ */
+class CorrelationMeter
+{
+public:
+    CorrelationMeter() noexcept
+        : fInvTimeConstant(0.f)
+    {
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        fSumLR = fSumLL = fSumRR = 0.f;
+    }
+
+   /**
+      Set the integration time, 300 ms is the usual choice for correlation meters.
+    */
+    void setup(const float integrationMs, const double sampleRate) noexcept
+    {
+        // log2(e) / samples, so the per-block decay is a single exp2
+        fInvTimeConstant = static_cast<float>(1.4426950408889634 / (integrationMs * 0.001 * sampleRate));
+    }
+
+   /**
+      Add a frame holding left and right in its first two lanes to the block sums.
+      Afterwards the first lane of @a cross holds the L*R sum, and the first two lanes of @a energy the L*L and R*R sums.
+    */
+    static inline void accumulate(const Float4 frame, Float4& cross, Float4& energy) noexcept
+    {
+        cross = cross + frame * swapPairs(frame);
+        energy = energy + frame * frame;
+    }
+
+   /**
+      Integrate the sums of a @a frames long block, as produced by accumulate().
+    */
+    void integrate(const Float4 cross, const Float4 energy, const uint32_t frames) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(frames != 0,);
+
+        float lr[4], squares[4];
+        cross.store(lr);
+        energy.store(squares);
+
+        const float decay = FastMath::exp2(-static_cast<float>(frames) * fInvTimeConstant);
+        const float weight = (1.f - decay) / static_cast<float>(frames);
+
+        fSumLR = fSumLR * decay + lr[0] * weight;
+        fSumLL = fSumLL * decay + squares[0] * weight;
+        fSumRR = fSumRR * decay + squares[1] * weight;
+
+        // flush to zero on silence, rather than decaying into denormals
+        if (fSumLL + fSumRR < kMeterSilence)
+            fSumLR = fSumLL = fSumRR = 0.f;
+    }
+
+   /**
+      Correlation between -1 (out of phase) and +1 (mono), 0 on silence.
+    */
+    float getCorrelation() const noexcept
+    {
+        const float product = fSumLL * fSumRR;
+
+        if (product < kMeterSilence * kMeterSilence)
+            return 0.f;
+
+        return std::max(-1.f, std::min(1.f, fSumLR / std::sqrt(product)));
+    }
+
+   /**
+      Level difference in dB, positive when the right channel is louder, limited to +/- @a range.
+    */
+    float getBalanceDB(const float range) const noexcept
+    {
+        if (fSumLL + fSumRR < kMeterSilence)
+            return 0.f;
+
+        // power ratio, hence half the gain conversion
+        const float balance = 0.5f * (FastMath::gainToDB(std::max(fSumRR, kMeterSilence))
+                                    - FastMath::gainToDB(std::max(fSumLL, kMeterSilence)));
+
+        return std::max(-range, std::min(range, 0.f + balance)); // no negative zero on display
+    }
+
+private:
+    float fInvTimeConstant;
+    float fSumLR, fSumLL, fSumRR;
+
+    DISTRHO_DECLARE_NON_COPYABLE(CorrelationMeter)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+// amplitude of -120 dB, the lowest meter reading
+static constexpr const float kBallisticsFloor = 1e-6f;
+
+// the VU reads the rectified average, scaled so a sine wave reads its RMS level, pi / (2 * sqrt(2))
+static constexpr const float kBallisticsVuScale = 1.1107207f;
+
+/**
+   Standard meter ballistics, as used by BallisticMeter.
+ */
+enum MeterBallistics {
+    kBallisticsPpmTypeI = 0, // IEC 60268-10 Type I (DIN), 5 ms integration, 20 dB fall in 1.5 s
+    kBallisticsPpmTypeII,    // IEC 60268-10 Type II (BBC, EBU), 10 ms integration, 24 dB fall in 2.8 s
+    kBallisticsVu,           // IEC 60268-17 VU, 99% of a step after 300 ms
+    kBallisticsRms,          // K-system average RMS, 99% of a step after 600 ms
+    kBallisticsCount
+};
+
+/**
+   Level meter with one of the standard ballistics, on interleaved frames of @a kLanes samples.
+
+   Readings follow the per-sample response of each standard exactly, but are integrated once per block on the
+   audio side, so they do not depend on how often the UI gets to repaint.
+
+   Peak programme meters are non-linear (they charge on peaks and fall at a constant rate in dB), so they run sample by
+   sample, with each group of 4 lanes in a register. A block whose peaks stay under the reading it decays to cannot
+   charge the meter, and collapses into a single multiply.
+
+   VU and RMS meters are linear filters of the rectified or squared signal, so the new state after a block is the old
+   state decayed over the whole block plus a weighted sum of the block samples. The weights are the filter impulse
+   response, tabled once for the longest block, and the sum has no dependency from one sample to the next.
+ */
+template <uint32_t kLanes>
+class BallisticMeter
+{
+    static_assert(kLanes % 4 == 0, "lanes must be padded to a multiple of 4");
+
+public:
+    BallisticMeter() noexcept
+        : fBallistics(kBallisticsPpmTypeI),
+          fAttack(0.f),
+          fRelease(0.f),
+          fLog2Release(0.f),
+          fGain(0.f),
+          fPowers(nullptr),
+          fRamp(nullptr),
+          fMaxBlockFrames(0)
+    {
+        reset();
+    }
+
+    ~BallisticMeter() noexcept
+    {
+        release();
+    }
+
+   /**
+      Reserve the impulse response tables for blocks of up to @a maxBlockFrames.
+      @note Not realtime-safe, must not be called from run().
+    */
+    void allocate(const uint32_t maxBlockFrames)
+    {
+        if (maxBlockFrames == fMaxBlockFrames)
+            return;
+
+        release();
+
+        // powers of the pole and the ramp of the second order response, each up to and including maxBlockFrames
+        fPowers = new float[2 * (maxBlockFrames + 1)];
+        fRamp = fPowers + maxBlockFrames + 1;
+        fMaxBlockFrames = maxBlockFrames;
+    }
+
+   /**
+      Free all reserved memory.
+      @note Not realtime-safe, must not be called from run().
+    */
+    void release() noexcept
+    {
+        delete[] fPowers;
+        fPowers = fRamp = nullptr;
+        fMaxBlockFrames = 0;
+    }
+
+    void reset() noexcept
+    {
+        for (uint32_t l = 0; l < kLanes; ++l)
+            fState1[l] = fState2[l] = 0.f;
+    }
+
+   /**
+      Select the @a ballistics and restart from silence.
+      Rebuilds the tables, so it costs about as much as metering a block.
+    */
+    void setup(const MeterBallistics ballistics, const double sampleRate) noexcept
+    {
+        fBallistics = ballistics;
+
+        switch (ballistics)
+        {
+        case kBallisticsPpmTypeI:
+            setupPeak(5.0, 20.0 / 1.5, sampleRate);
+            break;
+        case kBallisticsPpmTypeII:
+            setupPeak(10.0, 24.0 / 2.8, sampleRate);
+            break;
+        case kBallisticsVu:
+            // critically damped, the step response 1 - (1 + x) e^-x reaches 99% at x = 6.638
+            setupLinear(0.3 / 6.638, sampleRate);
+            break;
+        case kBallisticsRms:
+            // first order, 99% at ln(100) time constants
+            setupLinear(0.6 / 4.6052, sampleRate);
+            break;
+        case kBallisticsCount:
+            break;
+        }
+
+        reset();
+    }
+
+   /**
+      Meter @a frames interleaved frames, at most the size given to allocate().
+    */
+    void process(const float* const data, const uint32_t frames) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(frames <= fMaxBlockFrames,);
+
+        switch (fBallistics)
+        {
+        case kBallisticsPpmTypeI:
+        case kBallisticsPpmTypeII:
+            processPeak(data, frames);
+            break;
+        case kBallisticsVu:
+            processLinear<true>(data, frames);
+            break;
+        case kBallisticsRms:
+            processLinear<false>(data, frames);
+            break;
+        case kBallisticsCount:
+            break;
+        }
+    }
+
+   /**
+      Advance over @a frames frames of silence, same as processing them but without looking at any sample.
+    */
+    void decay(const uint32_t frames) noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(frames <= fMaxBlockFrames,);
+
+        const Float4 zero = Float4::broadcast(0.f);
+
+        for (uint32_t l = 0; l < kLanes; l += 4)
+        {
+            if (fBallistics == kBallisticsPpmTypeI || fBallistics == kBallisticsPpmTypeII)
+                store(Float4::load(fState1 + l) * Float4::broadcast(blockRelease(frames)), fState1 + l);
+            else
+                integrate(l, frames, zero, zero);
+        }
+    }
+
+   /**
+      Reading of @a lane in dBFS, calibrated so that a full scale sine wave reads 0 dB on the peak meters and
+      -3 dB (its RMS level) on the VU and RMS meters.
+    */
+    float getLevelDB(const uint32_t lane) const noexcept
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(lane < kLanes, -120.f);
+
+        switch (fBallistics)
+        {
+        case kBallisticsVu:
+            return FastMath::gainToDB(std::max(fState2[lane] * kBallisticsVuScale, kBallisticsFloor));
+        case kBallisticsRms:
+            // mean power, hence half the gain conversion
+            return 0.5f * FastMath::gainToDB(std::max(fState1[lane], kMeterSilence));
+        default:
+            return FastMath::gainToDB(std::max(fState1[lane], kBallisticsFloor));
+        }
+    }
+
+private:
+   /**
+      Peak programme meter, charging with the time constant that makes a tone burst of @a integrationMs read 2 dB
+      under its steady level, and falling at @a fallDBPerSecond.
+    */
+    void setupPeak(const double integrationMs, const double fallDBPerSecond, const double sampleRate) noexcept
+    {
+        // the rectified tone only charges the meter near its peaks, so rather than 1 - e^(-T/tau) = 10^(-2/20)
+        // for a steady input, tau is calibrated on the standard 5 kHz burst (same within 0.2 dB from 44.1 to 192 kHz)
+        const double tau = integrationMs * 0.001 / 3.64;
+
+        fAttack = static_cast<float>(1.0 - std::exp(-1.0 / (tau * sampleRate)));
+        fRelease = static_cast<float>(std::pow(10.0, -fallDBPerSecond / (20.0 * sampleRate)));
+        fLog2Release = std::log2(fRelease);
+    }
+
+   /**
+      One or two cascaded one-pole lowpass filters with @a tau seconds time constant,
+      tabling r^k and (k + 1) r^k for the block sums.
+    */
+    void setupLinear(const double tau, const double sampleRate) noexcept
+    {
+        const double pole = std::exp(-1.0 / (tau * sampleRate));
+        double power = 1.0;
+
+        fGain = static_cast<float>(1.0 - pole);
+
+        for (uint32_t k = 0; k <= fMaxBlockFrames; ++k)
+        {
+            fPowers[k] = static_cast<float>(power);
+            fRamp[k] = static_cast<float>(power * (k + 1));
+            power *= pole;
+        }
+    }
+
+    float blockRelease(const uint32_t frames) const noexcept
+    {
+        return FastMath::exp2(fLog2Release * static_cast<float>(frames));
+    }
+
+    void processPeak(const float* const __restrict data, const uint32_t frames) noexcept
+    {
+        const Float4 attack = Float4::broadcast(fAttack);
+        const Float4 release = Float4::broadcast(fRelease);
+        const Float4 blockDecay = Float4::broadcast(blockRelease(frames));
+
+        for (uint32_t l = 0; l < kLanes; l += 4)
+        {
+            Float4 level = Float4::load(fState1 + l);
+            Float4 peak = Float4::broadcast(0.f);
+
+            for (uint32_t i = 0; i < frames; ++i)
+                peak = simd::max(peak, simd::abs(Float4::load(data + i * kLanes + l)));
+
+            // nothing in the block reaches the level the meter falls to by its end, so nothing charges it either
+            float over[4];
+            (peak - level * blockDecay).store(over);
+
+            if (over[0] <= 0.f && over[1] <= 0.f && over[2] <= 0.f && over[3] <= 0.f)
+            {
+                store(level * blockDecay, fState1 + l);
+                continue;
+            }
+
+            for (uint32_t i = 0; i < frames; ++i)
+            {
+                const Float4 input = simd::abs(Float4::load(data + i * kLanes + l));
+
+                level = select(greaterThan(input, level), level + attack * (input - level), level * release);
+            }
+
+            store(level, fState1 + l);
+        }
+    }
+
+   /**
+      VU (@a kVu, second order on the rectified signal) or RMS (first order on the squared signal) block update.
+      With k counting frames from the end of the block, the first stage adds (1 - r) r^k x
+      and the second (1 - r)^2 (k + 1) r^k x, on top of the decayed state.
+    */
+    template <bool kVu>
+    void processLinear(const float* const __restrict data, const uint32_t frames) noexcept
+    {
+        const float* const powers = fPowers + frames - 1;
+        const float* const ramp = fRamp + frames - 1;
+
+        for (uint32_t l = 0; l < kLanes; l += 4)
+        {
+            Float4 sum1 = Float4::broadcast(0.f);
+            Float4 sum2 = Float4::broadcast(0.f);
+
+            for (uint32_t i = 0; i < frames; ++i)
+            {
+                const Float4 sample = Float4::load(data + i * kLanes + l);
+                const Float4 input = kVu ? simd::abs(sample) : sample * sample;
+
+                sum1 = sum1 + Float4::broadcast(*(powers - i)) * input;
+
+                if (kVu)
+                    sum2 = sum2 + Float4::broadcast(*(ramp - i)) * input;
+            }
+
+            integrate(l, frames, sum1, sum2);
+        }
+    }
+
+   /**
+      Apply the weighted block sums of lanes @a l to @a l + 3 to the filter state.
+    */
+    void integrate(const uint32_t l, const uint32_t frames, const Float4 sum1, const Float4 sum2) noexcept
+    {
+        const Float4 decay = Float4::broadcast(fPowers[frames]);
+        const Float4 gain = Float4::broadcast(fGain);
+        const Float4 state1 = Float4::load(fState1 + l);
+
+        if (fBallistics == kBallisticsVu)
+        {
+            // the first stage state also feeds the second over the whole block, with weight N (1 - r) r^N
+            const Float4 carry = Float4::broadcast(static_cast<float>(frames) * fGain * fPowers[frames]);
+
+            store(decay * Float4::load(fState2 + l) + carry * state1 + gain * gain * sum2, fState2 + l);
+        }
+
+        store(decay * state1 + gain * sum1, fState1 + l);
+    }
+
+   /**
+      Store @a value, flushing lanes that decayed far under the floor to zero, rather than into denormals.
+    */
+    static void store(const Float4 value, float* const state) noexcept
+    {
+        select(lessThan(value, Float4::broadcast(kMeterSilence)), Float4::broadcast(0.f), value).store(state);
+    }
+
+    MeterBallistics fBallistics;
+
+    // peak meters
+    float fAttack, fRelease, fLog2Release;
+
+    // VU and RMS meters, gain 1 - r of each stage and the impulse response tables
+    float fGain;
+    float* fPowers;
+    float* fRamp;
+    uint32_t fMaxBlockFrames;
+
+    // readings of the peak and RMS meters, or first stage of the VU
+    float fState1[kLanes];
+    // second stage of the VU
+    float fState2[kLanes];
+
+    DISTRHO_DECLARE_NON_COPYABLE(BallisticMeter)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // METERING_HPP_INCLUDED
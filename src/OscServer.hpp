@@ -0,0 +1,460 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef OSC_SERVER_HPP_INCLUDED
+#define OSC_SERVER_HPP_INCLUDED
+
+#include "DistrhoPlugin.hpp"
+#include "extra/Thread.hpp"
+
+#include "MeterBridge.hpp"
+#include "SpscQueue.hpp"
+
+#include <chrono>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Minimal OSC 1.0 server over UDP, for remote control of headless instances.
+
+   Understood messages:
+    - /gain f                  set the gain in dB
+    - /gain                    reply with /gain f, the current gain
+    - /meters/subscribe [i|f]  send meter bundles to the sender, at the given rate in Hz (default 20)
+    - /meters/unsubscribe      stop sending meter bundles to the sender
+
+   Meter bundles hold /meters/gain f, /meters/level f f, /meters/reduction f f (gate, compressor)
+   and /meters/correlation f, with the values the instance publishes to the meter bridge.
+
+   Everything runs on a thread of its own. Commands reach the audio thread through a bounded lock-free queue,
+   which the plugin drains at the start of each block, and the audio thread never waits on the network.
+
+   The plugin hands each command to the host as a parameter change request, so it shows in the automation lane and
+   gets saved with the session. Where the format or host does not support such requests, remote changes are
+   transient: they apply until the host sends its own value for the parameter, and are not saved.
+ */
+class OscServer : public Thread
+{
+public:
+    struct Command {
+        uint32_t index;
+        float value;
+    };
+
+    static constexpr const uint32_t kMaxSubscribers = 8;
+    static constexpr const uint32_t kMaxPacketSize = 1024;
+
+    explicit OscServer(const MeterBridge& meters) noexcept
+        : Thread("OSC server"),
+          fMeters(meters),
+          fSocket(-1)
+    {
+        for (uint32_t i = 0; i < kMaxSubscribers; ++i)
+            fSubscribers[i].active = false;
+    }
+
+    ~OscServer() override
+    {
+        stop();
+    }
+
+   /**
+      Listen on @a host and @a port, and start the server thread.
+      @note Not realtime-safe, must not be called from run().
+    */
+    bool start(const char* const host, const uint16_t port) noexcept
+    {
+        stop();
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+
+        if (inet_pton(AF_INET, host, &address.sin_addr) != 1)
+        {
+            d_stderr("OSC server: invalid address '%s'", host);
+            return false;
+        }
+
+        fSocket = socket(AF_INET, SOCK_DGRAM, 0);
+        DISTRHO_SAFE_ASSERT_RETURN(fSocket >= 0, false);
+
+        if (bind(fSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            // most likely another instance has the port already
+            d_stderr("OSC server: cannot listen on %s:%u", host, port);
+            closeSocket();
+            return false;
+        }
+
+        for (uint32_t i = 0; i < kMaxSubscribers; ++i)
+            fSubscribers[i].active = false;
+
+        fCommands.clear();
+        return startThread();
+    }
+
+   /**
+      Stop the server thread and close the socket.
+      @note Not realtime-safe, must not be called from run().
+    */
+    void stop() noexcept
+    {
+        if (isThreadRunning())
+            stopThread(1000);
+
+        closeSocket();
+    }
+
+   /**
+      Take the next pending command, from the audio thread.
+    */
+    bool takeCommand(Command& command) noexcept
+    {
+        return fCommands.pop(command);
+    }
+
+protected:
+    void run() override
+    {
+        uint8_t packet[kMaxPacketSize];
+
+        while (! shouldThreadExit())
+        {
+            pollfd pfd = { fSocket, POLLIN, 0 };
+
+            if (poll(&pfd, 1, getPollTimeout()) > 0)
+            {
+                sockaddr_in sender;
+                socklen_t senderSize = sizeof(sender);
+                ssize_t size;
+
+                while ((size = recvfrom(fSocket, packet, sizeof(packet), MSG_DONTWAIT,
+                                        reinterpret_cast<sockaddr*>(&sender), &senderSize)) > 0)
+                {
+                    handlePacket(packet, static_cast<uint32_t>(size), sender);
+                    senderSize = sizeof(sender);
+                }
+            }
+
+            sendMeters();
+        }
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Subscriber {
+        bool active;
+        sockaddr_in address;
+        Clock::duration interval;
+        Clock::time_point next;
+    };
+
+   /**
+      Outgoing packet, all values are written big-endian and padded to 4 bytes as OSC requires.
+    */
+    struct Packet {
+        uint8_t data[kMaxPacketSize];
+        uint32_t size = 0;
+
+        void writeInt(const uint32_t value) noexcept
+        {
+            DISTRHO_SAFE_ASSERT_RETURN(size + 4 <= kMaxPacketSize,);
+
+            data[size++] = static_cast<uint8_t>(value >> 24);
+            data[size++] = static_cast<uint8_t>(value >> 16);
+            data[size++] = static_cast<uint8_t>(value >> 8);
+            data[size++] = static_cast<uint8_t>(value);
+        }
+
+        void writeString(const char* const string) noexcept
+        {
+            const uint32_t length = static_cast<uint32_t>(std::strlen(string));
+            const uint32_t padded = (length + 4) & ~3u;
+            DISTRHO_SAFE_ASSERT_RETURN(size + padded <= kMaxPacketSize,);
+
+            std::memcpy(data + size, string, length);
+            std::memset(data + size + length, 0, padded - length);
+            size += padded;
+        }
+
+       /**
+          Message with @a count float arguments, as a bundle element when @a inBundle is set.
+        */
+        void writeMessage(const char* const address, const float* const values, const uint32_t count,
+                          const bool inBundle) noexcept
+        {
+            static const char* const kTypes[] = { ",", ",f", ",ff" };
+            DISTRHO_SAFE_ASSERT_RETURN(count < 3,);
+
+            const uint32_t start = size;
+
+            if (inBundle)
+                writeInt(0);
+
+            writeString(address);
+            writeString(kTypes[count]);
+
+            for (uint32_t i = 0; i < count; ++i)
+                writeInt(static_cast<uint32_t>(FastMath::floatToBits(values[i])));
+
+            // patch in the element size, now that it is known
+            if (inBundle)
+            {
+                const uint32_t end = size;
+                size = start;
+                writeInt(end - start - 4);
+                size = end;
+            }
+        }
+    };
+
+    const MeterBridge& fMeters;
+    SpscQueue<Command, 64> fCommands;
+    int fSocket;
+    Subscriber fSubscribers[kMaxSubscribers];
+
+    void closeSocket() noexcept
+    {
+        if (fSocket < 0)
+            return;
+
+        ::close(fSocket);
+        fSocket = -1;
+    }
+
+   /**
+      Wait for packets until the next meter bundle is due, but never so long that stopping the thread would lag.
+    */
+    int getPollTimeout() const noexcept
+    {
+        const Clock::time_point now = Clock::now();
+        Clock::duration wait = std::chrono::milliseconds(50);
+
+        for (uint32_t i = 0; i < kMaxSubscribers; ++i)
+            if (fSubscribers[i].active)
+                wait = std::min(wait, fSubscribers[i].next - now);
+
+        return static_cast<int>(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::milliseconds>(wait).count()));
+    }
+
+    static uint32_t readInt(const uint8_t* const data) noexcept
+    {
+        return static_cast<uint32_t>(data[0]) << 24 | static_cast<uint32_t>(data[1]) << 16
+             | static_cast<uint32_t>(data[2]) << 8 | static_cast<uint32_t>(data[3]);
+    }
+
+   /**
+      Read a padded string at @a offset and move past it, null if it is not terminated within the packet.
+    */
+    static const char* readString(const uint8_t* const data, const uint32_t size, uint32_t& offset) noexcept
+    {
+        const char* const string = reinterpret_cast<const char*>(data + offset);
+        const void* const end = std::memchr(string, 0, size - offset);
+
+        if (end == nullptr)
+            return nullptr;
+
+        offset += (static_cast<uint32_t>(static_cast<const char*>(end) - string) + 4) & ~3u;
+        return offset <= size ? string : nullptr;
+    }
+
+    void handlePacket(const uint8_t* const data, const uint32_t size, const sockaddr_in& sender) noexcept
+    {
+        if (size < 4 || size % 4 != 0)
+            return;
+
+        // bundles are unpacked recursively, their time tags are ignored and everything runs at once
+        if (size >= 16 && std::memcmp(data, "#bundle", 8) == 0)
+        {
+            for (uint32_t offset = 16; offset + 4 <= size;)
+            {
+                const uint32_t elementSize = readInt(data + offset);
+                offset += 4;
+
+                if (elementSize > size - offset)
+                    return;
+
+                handlePacket(data + offset, elementSize, sender);
+                offset += elementSize;
+            }
+            return;
+        }
+
+        uint32_t offset = 0;
+        const char* const address = readString(data, size, offset);
+
+        if (address == nullptr)
+            return;
+
+        // arguments, only numbers are of interest
+        const char* types = offset < size ? readString(data, size, offset) : ",";
+
+        if (types == nullptr || types[0] != ',')
+            return;
+
+        float args[2];
+        uint32_t count = 0;
+
+        for (++types; *types != '\0' && count < 2; ++types)
+        {
+            if (offset + 4 > size)
+                return;
+
+            const uint32_t bits = readInt(data + offset);
+            offset += 4;
+
+            switch (*types)
+            {
+            case 'f':
+                args[count++] = FastMath::bitsToFloat(static_cast<int32_t>(bits));
+                break;
+            case 'i':
+                args[count++] = static_cast<float>(static_cast<int32_t>(bits));
+                break;
+            default:
+                return;
+            }
+        }
+
+        handleMessage(address, args, count, sender);
+    }
+
+    void handleMessage(const char* const address, const float* const args, const uint32_t count,
+                       const sockaddr_in& sender) noexcept
+    {
+        if (std::strcmp(address, "/gain") == 0)
+        {
+            if (count != 0)
+            {
+                const Command command = { kParamGain, args[0] };
+
+                if (! fCommands.push(command))
+                    d_stderr("OSC server: command queue is full, dropping /gain");
+                return;
+            }
+
+            float values[kMeterBridgeValueCount];
+
+            if (fMeters.readPublished(values))
+            {
+                Packet reply;
+                reply.writeMessage("/gain", &values[kMeterBridgeGain], 1, false);
+                sendPacket(reply, sender);
+            }
+        }
+        else if (std::strcmp(address, "/meters/subscribe") == 0)
+        {
+            const float rate = count != 0 ? std::max(1.0f, std::min(100.0f, args[0])) : 20.0f;
+            subscribe(sender, rate);
+        }
+        else if (std::strcmp(address, "/meters/unsubscribe") == 0)
+        {
+            if (Subscriber* const subscriber = findSubscriber(sender))
+                subscriber->active = false;
+        }
+    }
+
+    Subscriber* findSubscriber(const sockaddr_in& address) noexcept
+    {
+        for (uint32_t i = 0; i < kMaxSubscribers; ++i)
+        {
+            Subscriber& subscriber(fSubscribers[i]);
+
+            if (subscriber.active
+                && subscriber.address.sin_addr.s_addr == address.sin_addr.s_addr
+                && subscriber.address.sin_port == address.sin_port)
+                return &subscriber;
+        }
+
+        return nullptr;
+    }
+
+    void subscribe(const sockaddr_in& address, const float rate) noexcept
+    {
+        Subscriber* subscriber = findSubscriber(address);
+
+        for (uint32_t i = 0; i < kMaxSubscribers && subscriber == nullptr; ++i)
+            if (! fSubscribers[i].active)
+                subscriber = &fSubscribers[i];
+
+        if (subscriber == nullptr)
+        {
+            d_stderr("OSC server: too many meter subscribers");
+            return;
+        }
+
+        subscriber->active = true;
+        subscriber->address = address;
+        subscriber->interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(1.0f / rate));
+        subscriber->next = Clock::now();
+    }
+
+   /**
+      Send a bundle with all meter values to every subscriber that is due.
+    */
+    void sendMeters() noexcept
+    {
+        const Clock::time_point now = Clock::now();
+        float values[kMeterBridgeValueCount];
+        bool haveValues = false;
+        Packet bundle;
+
+        for (uint32_t i = 0; i < kMaxSubscribers; ++i)
+        {
+            Subscriber& subscriber(fSubscribers[i]);
+
+            if (! subscriber.active || subscriber.next > now)
+                continue;
+
+            // keep the pace, but do not try to catch up after a stall
+            subscriber.next = std::max(subscriber.next + subscriber.interval, now);
+
+            if (! haveValues)
+            {
+                if (! fMeters.readPublished(values))
+                    return;
+
+                haveValues = true;
+
+                bundle.writeString("#bundle");
+                bundle.writeInt(0);
+                bundle.writeInt(1); // time tag for "immediately"
+                bundle.writeMessage("/meters/gain", &values[kMeterBridgeGain], 1, true);
+                bundle.writeMessage("/meters/level", &values[kMeterBridgeLevelLeft], 2, true);
+                bundle.writeMessage("/meters/reduction", &values[kMeterBridgeGateReduction], 2, true);
+                bundle.writeMessage("/meters/correlation", &values[kMeterBridgeCorrelation], 1, true);
+            }
+
+            sendPacket(bundle, subscriber.address);
+        }
+    }
+
+    void sendPacket(const Packet& packet, const sockaddr_in& address) noexcept
+    {
+        sendto(fSocket, packet.data, packet.size, MSG_DONTWAIT,
+               reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    }
+
+    DISTRHO_DECLARE_NON_COPYABLE(OscServer)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // OSC_SERVER_HPP_INCLUDED
@@ -0,0 +1,127 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef PARAMETER_MAILBOX_HPP_INCLUDED
+#define PARAMETER_MAILBOX_HPP_INCLUDED
+
+#include "FastMath.hpp"
+
+#include <atomic>
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Parameter values handed from the threads the host calls setParameterValue() on to the audio thread.
+
+   Each parameter has a single slot holding its latest value, plus a bit in a changed mask.
+   Posting stores the value and then sets the bit, the audio thread takes the whole mask at the start of a block and
+   reads the slots whose bit was set, so several changes to a parameter between two blocks arrive as the last one.
+   Nothing can overflow, there is no lock, and a value is always read whole as it is a single 32 bit atomic.
+
+   A value posted while the audio thread is collecting may be seen in that block and again in the next one,
+   applying a parameter twice with the same value is harmless.
+
+   Output parameters use the same slots the other way around, published by the audio thread for any thread to read.
+
+   The slots are the only memory written from outside the audio thread, so they are padded on both sides to keep them
+   off the cache lines of whatever the owner places around them.
+ */
+template <uint32_t kCount>
+class ParameterMailbox
+{
+    static constexpr const uint32_t kMaskWords = (kCount + 31) / 32;
+
+public:
+    ParameterMailbox() noexcept
+    {
+        for (uint32_t i = 0; i < kCount; ++i)
+            fValues[i].store(0, std::memory_order_relaxed);
+
+        for (uint32_t i = 0; i < kMaskWords; ++i)
+            fChanged[i].store(0, std::memory_order_relaxed);
+    }
+
+   /**
+      Set the initial value of parameter @a index, without marking it as changed.
+      Only valid while no other thread uses the mailbox.
+    */
+    void init(const uint32_t index, const float value) noexcept
+    {
+        fValues[index].store(static_cast<uint32_t>(FastMath::floatToBits(value)), std::memory_order_relaxed);
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // Any thread
+
+   /**
+      Deliver @a value for input parameter @a index to the audio thread, replacing any value not collected yet.
+    */
+    void post(const uint32_t index, const float value) noexcept
+    {
+        fValues[index].store(static_cast<uint32_t>(FastMath::floatToBits(value)), std::memory_order_relaxed);
+        fChanged[index / 32].fetch_or(1u << (index % 32), std::memory_order_release);
+    }
+
+   /**
+      The last value posted or published for parameter @a index.
+    */
+    float read(const uint32_t index) const noexcept
+    {
+        return FastMath::bitsToFloat(static_cast<int32_t>(fValues[index].load(std::memory_order_relaxed)));
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // Audio thread
+
+   /**
+      Call @a apply with the index and value of every parameter posted since the last call.
+    */
+    template <typename Apply>
+    void collect(Apply&& apply) noexcept
+    {
+        for (uint32_t w = 0; w < kMaskWords; ++w)
+        {
+            // cheap check first, most blocks have no changes at all
+            if (fChanged[w].load(std::memory_order_relaxed) == 0)
+                continue;
+
+            // pairs with the release in post(), so the values read below are at least as new as the bits
+            uint32_t changed = fChanged[w].exchange(0, std::memory_order_acquire);
+
+            for (uint32_t index = w * 32; changed != 0; ++index, changed >>= 1)
+            {
+                if (changed & 1)
+                    apply(index, read(index));
+            }
+        }
+    }
+
+   /**
+      Make @a value the current value of output parameter @a index.
+    */
+    void publish(const uint32_t index, const float value) noexcept
+    {
+        fValues[index].store(static_cast<uint32_t>(FastMath::floatToBits(value)), std::memory_order_relaxed);
+    }
+
+private:
+    // a full cache line on each side (no alignas, as plugin instances come from plain operator new)
+    char fPaddingBefore[64];
+    std::atomic<uint32_t> fValues[kCount]; // float bits
+    std::atomic<uint32_t> fChanged[kMaskWords];
+    char fPaddingAfter[64];
+
+    DISTRHO_DECLARE_NON_COPYABLE(ParameterMailbox)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // PARAMETER_MAILBOX_HPP_INCLUDED
@@ -8,6 +8,23 @@
 #include "DistrhoPlugin.hpp"
 #include "extra/ValueSmoother.hpp"
 
+#include "Biquad.hpp"
+#include "Delay.hpp"
+#include "Dither.hpp"
+#include "Dynamics.hpp"
+#include "EventLog.hpp"
+#include "ImGuiPluginBase.hpp"
+#include "MeterBridge.hpp"
+#include "Metering.hpp"
+#include "ParameterMailbox.hpp"
+#include "ScratchArena.hpp"
+
+#ifdef IMGUI_PLUGIN_OSC
+# include "OscServer.hpp"
+#endif
+
+#include <cfloat>
+
 START_NAMESPACE_DISTRHO
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -22,29 +39,190 @@ static constexpr const float DB_CO(float g)
     return g > -90.f ? std::pow(10.f, g * 0.05f) : 0.f;
 }
 
+// number of audio channels, and the same rounded up to a whole SIMD register of floats
+static constexpr const uint32_t kNumChannels = DISTRHO_PLUGIN_NUM_INPUTS;
+static constexpr const uint32_t kNumLanes = (kNumChannels + 3) & ~3u;
+
+// host blocks are processed in chunks of at most this many frames, running every stage over a chunk before the next
+// one, so the intermediate buffers stay in L1 cache however large the host buffers are
+static constexpr const uint32_t kMaxChunkFrames = 256;
+
+// filter coefficients are recomputed and interpolated once per this many frames
+static constexpr const uint32_t kFilterBlockSize = 32;
+
+// high-pass filter is disabled when set to its minimum frequency
+static constexpr const float kHighPassOffFreq = 10.0f;
+
+// correlation and balance meters need a stereo pair in the first two channels
+static_assert(kNumChannels >= 2, "metering expects at least 2 channels");
+
+// longest per-channel alignment delay
+static constexpr const float kMaxDelayMs = 50.0f;
+
+// alignment settings are indexed by channel from the first delay and polarity parameters
+static_assert(kParamDelayRight - kParamDelayLeft + 1 == kNumChannels
+              && kParamPolarityRight - kParamPolarityLeft + 1 == kNumChannels,
+              "alignment expects one delay and one polarity parameter per channel");
+
+// dither word lengths selectable by kParamDither, 0 is off
+static constexpr const uint32_t kDitherBits[] = { 0, 16, 20, 24 };
+
+// outputs below this peak level (-160 dB) count as silence, far under the 24-bit noise floor,
+// inputs only when they hold nothing but zeros and denormals, as the processing can add a lot of gain
+static constexpr const float kSilenceLevel = 1e-8f;
+static constexpr const float kInputSilenceLevel = FLT_MIN;
+
+// ballistics of each kParamMeterMode value, the K-system scales only differ in the UI
+static constexpr const MeterBallistics kMeterModeBallistics[] = {
+    kBallisticsPpmTypeI, kBallisticsPpmTypeII, kBallisticsVu, kBallisticsRms, kBallisticsRms, kBallisticsRms
+};
+
+// gate is disabled when set to its minimum threshold
+static constexpr const float kGateOffThreshold = -90.0f;
+
+static constexpr const struct {
+    float min, max, def;
+} kParameterRanges[kParamCount] = {
+    { -90.0f, 30.0f, 0.0f },        // kParamGain
+    { kHighPassOffFreq, 1000.0f, kHighPassOffFreq }, // kParamHighPassFreq
+    { 20.0f, 1000.0f, 100.0f },     // kParamLowShelfFreq
+    { -18.0f, 18.0f, 0.0f },        // kParamLowShelfGain
+    { 20.0f, 20000.0f, 1000.0f },   // kParamBellFreq
+    { -18.0f, 18.0f, 0.0f },        // kParamBellGain
+    { 0.1f, 10.0f, 0.7071f },       // kParamBellQ
+    { 1000.0f, 20000.0f, 10000.0f }, // kParamHighShelfFreq
+    { -18.0f, 18.0f, 0.0f },        // kParamHighShelfGain
+    { kGateOffThreshold, 0.0f, kGateOffThreshold }, // kParamGateThreshold
+    { 1.0f, 20.0f, 20.0f },         // kParamGateRatio
+    { 0.0f, 90.0f, 60.0f },         // kParamGateRange
+    { 0.0f, 12.0f, 3.0f },          // kParamGateHysteresis
+    { 0.0f, 500.0f, 20.0f },        // kParamGateHold
+    { 0.1f, 50.0f, 1.0f },          // kParamGateAttack
+    { 5.0f, 2000.0f, 100.0f },      // kParamGateRelease
+    { 0.0f, 90.0f, 0.0f },          // kParamGateReduction
+    { -60.0f, 0.0f, 0.0f },         // kParamCompThreshold
+    { 1.0f, 20.0f, 1.0f },          // kParamCompRatio
+    { 0.0f, 24.0f, 6.0f },          // kParamCompKnee
+    { 0.1f, 100.0f, 10.0f },        // kParamCompAttack
+    { 10.0f, 2000.0f, 100.0f },     // kParamCompRelease
+    { 0.0f, 24.0f, 0.0f },          // kParamCompMakeup
+    { 0.0f, 1.0f, 1.0f },           // kParamCompLink
+    { 0.0f, 60.0f, 0.0f },          // kParamCompReduction
+    { -1.0f, 1.0f, 0.0f },          // kParamCorrelation
+    { -24.0f, 24.0f, 0.0f },        // kParamBalance
+    { 0.0f, 1.0f, 0.0f },           // kParamAlignment
+    { 0.0f, kMaxDelayMs, 0.0f },    // kParamDelayLeft
+    { 0.0f, kMaxDelayMs, 0.0f },    // kParamDelayRight
+    { 0.0f, 1.0f, 0.0f },           // kParamPolarityLeft
+    { 0.0f, 1.0f, 0.0f },           // kParamPolarityRight
+    { 0.0f, 3.0f, 0.0f },           // kParamDither
+    { 0.0f, 3.0f, 0.0f },           // kParamDitherShaping
+    { 0.0f, 5.0f, 0.0f },           // kParamMeterMode
+    { -90.0f, 6.0f, -90.0f },       // kParamMeterLeft
+    { -90.0f, 6.0f, -90.0f },       // kParamMeterRight
+};
+
 // --------------------------------------------------------------------------------------------------------------------
 
-class ImGuiPluginDSP : public Plugin
+class ImGuiPluginDSP : public ImGuiPluginBase
 {
-    enum Parameters {
-        kParamGain = 0,
-        kParamCount
+    enum FilterStages {
+        kFilterHighPass = 0,
+        kFilterLowShelf,
+        kFilterBell,
+        kFilterHighShelf,
+        kFilterCount
     };
 
-    float fGainDB = 0.0f;
+    // tone shaping parameters, contiguous from kParamHighPassFreq
+    static constexpr const uint32_t kFilterParamFirst = kParamHighPassFreq;
+    static constexpr const uint32_t kFilterParamCount = kParamHighShelfGain - kParamHighPassFreq + 1;
+
+    // values posted by the host from any thread, and output values published for it,
+    // on cache lines of their own so host calls do not disturb the audio thread state below
+    ParameterMailbox<kParamCount> fParameterMailbox;
+
+    // values as applied by the audio thread, input changes are collected from the mailbox at the start of each block
+    float fParameters[kParamCount];
     ExponentialValueSmoother fSmoothGain;
 
+    // channel alignment, ring buffers are allocated on activate for the maximum delay
+    DelayLine<kNumChannels> fDelay;
+    float fPolarity[kNumChannels];
+    bool fDelayChanged = true;
+    bool fDelayEnabled = false;
+
+    // filter parameters are smoothed at kFilterBlockSize rate, last designed values kept to skip redundant work
+    ExponentialValueSmoother fSmoothFilter[kFilterParamCount];
+    float fFilterValues[kFilterParamCount];
+    BiquadCascade<kFilterCount, kNumLanes> fFilters;
+
+    // gate settings are applied at the start of the next chunk, as they rebuild a table
+    NoiseGate<kNumChannels, kNumLanes> fGate;
+    bool fGateChanged = true;
+
+    // same for the compressor
+    Compressor<kNumChannels, kNumLanes> fCompressor;
+    bool fCompressorChanged = true;
+
+    // output metering, sums are collected in the final gain pass
+    CorrelationMeter fCorrelation;
+
+    // standard level meter on the output, ballistics are applied at the start of the next chunk as they rebuild tables
+    BallisticMeter<kNumLanes> fMeter;
+    bool fMeterChanged = true;
+
+    // slot in the meter table shared by all instances, claimed while active,
+    // output energy of the first 2 channels is summed over the chunks of a host block and published once per block
+    MeterBridge fMeterBridge;
+    float fMeterBridgeEnergy[2] = {};
+
+   #ifdef IMGUI_PLUGIN_OSC
+    // remote control, listening while active if IMGUI_PLUGIN_OSC_PORT is set in the environment
+    OscServer fOscServer { fMeterBridge };
+   #endif
+
+    // output dither, also applied in the final gain pass
+    Dither<kNumLanes> fDither;
+    bool fDitherChanged = true;
+
+    // non-finite input samples are replaced with silence before reaching any stage state,
+    // counting the blocks in which that happened to report when the input is clean again
+    uint32_t fNonFiniteBlocks = 0;
+
+    // silent input is not processed once all stage tails have died out,
+    // the delay rings need the input silent for at least their length before that
+    bool fSilent = false;
+    uint32_t fSilentInputFrames = 0;
+    uint32_t fSilenceHoldFrames = 0;
+
+    // memory for intermediate buffers, sized for the host maximum buffer size up to kMaxChunkFrames
+    ScratchArena fScratch;
+    uint32_t fScratchFrames = 0;
+
+    // host blocks larger than announced are only logged once per activation, as some hosts send them all the time,
+    // see fLogSource for the records of this instance
+    bool fLoggedSplit = false;
+
 public:
    /**
       Plugin class constructor.@n
       You must set all parameter values to their defaults, matching ParameterRanges::def.
     */
     ImGuiPluginDSP()
-        : Plugin(kParamCount, 0, 0) // parameters, programs, states
+        : ImGuiPluginBase(kParamCount, 0, kStateCount) // parameters, programs, states
     {
-        fSmoothGain.setSampleRate(getSampleRate());
-        fSmoothGain.setTargetValue(DB_CO(0.f));
-        fSmoothGain.setTimeConstant(0.020f); // 20ms
+        for (uint32_t i = 0; i < kParamCount; ++i)
+        {
+            fParameters[i] = kParameterRanges[i].def;
+            fParameterMailbox.init(i, kParameterRanges[i].def);
+        }
+
+        for (uint32_t c = 0; c < kNumChannels; ++c)
+            fPolarity[c] = 1.0f;
+
+        // everything else depends on the sample rate and is set up in activate(),
+        // so hosts scanning or instantiating the plugin without running it do not pay for it
     }
 
 protected:
@@ -114,16 +292,309 @@ protected:
     */
     void initParameter(uint32_t index, Parameter& parameter) override
     {
-        DISTRHO_SAFE_ASSERT_RETURN(index == 0,);
+        DISTRHO_SAFE_ASSERT_RETURN(index < kParamCount,);
 
-        parameter.ranges.min = -90.0f;
-        parameter.ranges.max = 30.0f;
-        parameter.ranges.def = 0.0f;
+        parameter.ranges.min = kParameterRanges[index].min;
+        parameter.ranges.max = kParameterRanges[index].max;
+        parameter.ranges.def = kParameterRanges[index].def;
         parameter.hints = kParameterIsAutomatable;
-        parameter.name = "Gain";
-        parameter.shortName = "Gain";
-        parameter.symbol = "gain";
-        parameter.unit = "dB";
+
+        switch (index)
+        {
+        case kParamGain:
+            parameter.name = "Gain";
+            parameter.shortName = "Gain";
+            parameter.symbol = "gain";
+            parameter.unit = "dB";
+            break;
+        case kParamHighPassFreq:
+            parameter.hints |= kParameterIsLogarithmic;
+            parameter.name = "High-pass Frequency";
+            parameter.shortName = "HP Freq";
+            parameter.symbol = "hp_freq";
+            parameter.unit = "Hz";
+            parameter.description = "High-pass filter cutoff, the minimum value turns the filter off";
+            break;
+        case kParamLowShelfFreq:
+            parameter.hints |= kParameterIsLogarithmic;
+            parameter.name = "Low-shelf Frequency";
+            parameter.shortName = "LS Freq";
+            parameter.symbol = "ls_freq";
+            parameter.unit = "Hz";
+            break;
+        case kParamLowShelfGain:
+            parameter.name = "Low-shelf Gain";
+            parameter.shortName = "LS Gain";
+            parameter.symbol = "ls_gain";
+            parameter.unit = "dB";
+            break;
+        case kParamBellFreq:
+            parameter.hints |= kParameterIsLogarithmic;
+            parameter.name = "Bell Frequency";
+            parameter.shortName = "Bell Freq";
+            parameter.symbol = "bell_freq";
+            parameter.unit = "Hz";
+            break;
+        case kParamBellGain:
+            parameter.name = "Bell Gain";
+            parameter.shortName = "Bell Gain";
+            parameter.symbol = "bell_gain";
+            parameter.unit = "dB";
+            break;
+        case kParamBellQ:
+            parameter.hints |= kParameterIsLogarithmic;
+            parameter.name = "Bell Q";
+            parameter.shortName = "Bell Q";
+            parameter.symbol = "bell_q";
+            break;
+        case kParamHighShelfFreq:
+            parameter.hints |= kParameterIsLogarithmic;
+            parameter.name = "High-shelf Frequency";
+            parameter.shortName = "HS Freq";
+            parameter.symbol = "hs_freq";
+            parameter.unit = "Hz";
+            break;
+        case kParamHighShelfGain:
+            parameter.name = "High-shelf Gain";
+            parameter.shortName = "HS Gain";
+            parameter.symbol = "hs_gain";
+            parameter.unit = "dB";
+            break;
+        case kParamGateThreshold:
+            parameter.name = "Gate Threshold";
+            parameter.shortName = "Gate Thres";
+            parameter.symbol = "gate_threshold";
+            parameter.unit = "dB";
+            parameter.description = "Noise gate threshold, the minimum value turns the gate off";
+            break;
+        case kParamGateRatio:
+            parameter.name = "Gate Ratio";
+            parameter.shortName = "Gate Ratio";
+            parameter.symbol = "gate_ratio";
+            parameter.description = "Downward expansion ratio below the threshold";
+            break;
+        case kParamGateRange:
+            parameter.name = "Gate Range";
+            parameter.shortName = "Gate Range";
+            parameter.symbol = "gate_range";
+            parameter.unit = "dB";
+            break;
+        case kParamGateHysteresis:
+            parameter.name = "Gate Hysteresis";
+            parameter.shortName = "Gate Hyst";
+            parameter.symbol = "gate_hysteresis";
+            parameter.unit = "dB";
+            break;
+        case kParamGateHold:
+            parameter.name = "Gate Hold";
+            parameter.shortName = "Gate Hold";
+            parameter.symbol = "gate_hold";
+            parameter.unit = "ms";
+            break;
+        case kParamGateAttack:
+            parameter.hints |= kParameterIsLogarithmic;
+            parameter.name = "Gate Attack";
+            parameter.shortName = "Gate Att";
+            parameter.symbol = "gate_attack";
+            parameter.unit = "ms";
+            break;
+        case kParamGateRelease:
+            parameter.hints |= kParameterIsLogarithmic;
+            parameter.name = "Gate Release";
+            parameter.shortName = "Gate Rel";
+            parameter.symbol = "gate_release";
+            parameter.unit = "ms";
+            break;
+        case kParamGateReduction:
+            parameter.hints = kParameterIsOutput;
+            parameter.name = "Gate Reduction";
+            parameter.shortName = "Gate GR";
+            parameter.symbol = "gate_reduction";
+            parameter.unit = "dB";
+            break;
+        case kParamCompThreshold:
+            parameter.name = "Compressor Threshold";
+            parameter.shortName = "Comp Thres";
+            parameter.symbol = "comp_threshold";
+            parameter.unit = "dB";
+            break;
+        case kParamCompRatio:
+            parameter.hints |= kParameterIsLogarithmic;
+            parameter.name = "Compressor Ratio";
+            parameter.shortName = "Comp Ratio";
+            parameter.symbol = "comp_ratio";
+            parameter.description = "Compression ratio above the threshold, a ratio of 1 turns the compressor off";
+            break;
+        case kParamCompKnee:
+            parameter.name = "Compressor Knee";
+            parameter.shortName = "Comp Knee";
+            parameter.symbol = "comp_knee";
+            parameter.unit = "dB";
+            break;
+        case kParamCompAttack:
+            parameter.hints |= kParameterIsLogarithmic;
+            parameter.name = "Compressor Attack";
+            parameter.shortName = "Comp Att";
+            parameter.symbol = "comp_attack";
+            parameter.unit = "ms";
+            break;
+        case kParamCompRelease:
+            parameter.hints |= kParameterIsLogarithmic;
+            parameter.name = "Compressor Release";
+            parameter.shortName = "Comp Rel";
+            parameter.symbol = "comp_release";
+            parameter.unit = "ms";
+            break;
+        case kParamCompMakeup:
+            parameter.name = "Compressor Makeup";
+            parameter.shortName = "Comp Makeup";
+            parameter.symbol = "comp_makeup";
+            parameter.unit = "dB";
+            break;
+        case kParamCompLink:
+            parameter.hints |= kParameterIsBoolean;
+            parameter.name = "Compressor Stereo Link";
+            parameter.shortName = "Comp Link";
+            parameter.symbol = "comp_link";
+            break;
+        case kParamCompReduction:
+            parameter.hints = kParameterIsOutput;
+            parameter.name = "Compressor Reduction";
+            parameter.shortName = "Comp GR";
+            parameter.symbol = "comp_reduction";
+            parameter.unit = "dB";
+            break;
+        case kParamCorrelation:
+            parameter.hints = kParameterIsOutput;
+            parameter.name = "Correlation";
+            parameter.symbol = "correlation";
+            parameter.description = "Phase correlation of the first two outputs, -1 is out of phase and +1 is mono";
+            break;
+        case kParamBalance:
+            parameter.hints = kParameterIsOutput;
+            parameter.name = "Balance";
+            parameter.symbol = "balance";
+            parameter.unit = "dB";
+            parameter.description = "Level difference between the first two outputs, positive when right is louder";
+            break;
+        case kParamAlignment:
+            // not automatable, switching changes the latency and hosts re-align their delay compensation for it
+            parameter.hints = kParameterIsBoolean;
+            parameter.name = "Alignment";
+            parameter.symbol = "alignment";
+            parameter.description = "Per-channel alignment delays, adding 1 sample of latency to all channels while on";
+            break;
+        case kParamDelayLeft:
+        case kParamDelayRight:
+            parameter.name = index == kParamDelayLeft ? "Delay Left" : "Delay Right";
+            parameter.shortName = index == kParamDelayLeft ? "Delay L" : "Delay R";
+            parameter.symbol = index == kParamDelayLeft ? "delay_left" : "delay_right";
+            parameter.unit = "ms";
+            parameter.description = "Alignment delay, applied while alignment is on";
+            break;
+        case kParamPolarityLeft:
+        case kParamPolarityRight:
+            parameter.hints |= kParameterIsBoolean;
+            parameter.name = index == kParamPolarityLeft ? "Invert Left" : "Invert Right";
+            parameter.shortName = index == kParamPolarityLeft ? "Invert L" : "Invert R";
+            parameter.symbol = index == kParamPolarityLeft ? "invert_left" : "invert_right";
+            break;
+        case kParamDither:
+            parameter.hints |= kParameterIsInteger;
+            parameter.name = "Dither";
+            parameter.symbol = "dither";
+            parameter.description = "TPDF dither to the target word length, for fixed-point export";
+            if (ParameterEnumerationValue* const values = new ParameterEnumerationValue[4])
+            {
+                parameter.enumValues.count = 4;
+                parameter.enumValues.restrictedMode = true;
+                parameter.enumValues.values = values;
+                values[0].label = "Off";
+                values[0].value = 0.0f;
+                values[1].label = "16 bit";
+                values[1].value = 1.0f;
+                values[2].label = "20 bit";
+                values[2].value = 2.0f;
+                values[3].label = "24 bit";
+                values[3].value = 3.0f;
+            }
+            break;
+        case kParamDitherShaping:
+            parameter.hints |= kParameterIsInteger;
+            parameter.name = "Noise Shaping";
+            parameter.shortName = "Shaping";
+            parameter.symbol = "dither_shaping";
+            if (ParameterEnumerationValue* const values = new ParameterEnumerationValue[4])
+            {
+                parameter.enumValues.count = 4;
+                parameter.enumValues.restrictedMode = true;
+                parameter.enumValues.values = values;
+                values[0].label = "None";
+                values[0].value = 0.0f;
+                values[1].label = "1st order";
+                values[1].value = 1.0f;
+                values[2].label = "2nd order";
+                values[2].value = 2.0f;
+                values[3].label = "F-weighted";
+                values[3].value = 3.0f;
+            }
+            break;
+        case kParamMeterMode:
+            parameter.hints |= kParameterIsInteger;
+            parameter.name = "Meter Mode";
+            parameter.shortName = "Meter";
+            parameter.symbol = "meter_mode";
+            parameter.description = "Ballistics of the output level meter";
+            if (ParameterEnumerationValue* const values = new ParameterEnumerationValue[6])
+            {
+                parameter.enumValues.count = 6;
+                parameter.enumValues.restrictedMode = true;
+                parameter.enumValues.values = values;
+                values[0].label = "PPM Type I";
+                values[0].value = 0.0f;
+                values[1].label = "PPM Type II";
+                values[1].value = 1.0f;
+                values[2].label = "VU";
+                values[2].value = 2.0f;
+                values[3].label = "K-20";
+                values[3].value = 3.0f;
+                values[4].label = "K-14";
+                values[4].value = 4.0f;
+                values[5].label = "K-12";
+                values[5].value = 5.0f;
+            }
+            break;
+        case kParamMeterLeft:
+        case kParamMeterRight:
+            parameter.hints = kParameterIsOutput;
+            parameter.name = index == kParamMeterLeft ? "Meter Left" : "Meter Right";
+            parameter.shortName = index == kParamMeterLeft ? "Meter L" : "Meter R";
+            parameter.symbol = index == kParamMeterLeft ? "meter_left" : "meter_right";
+            parameter.unit = "dB";
+            parameter.description = "Output level with the ballistics of the meter mode, relative to full scale";
+            break;
+        }
+    }
+
+   /**
+      Initialize the state @a index.@n
+      This function will be called once, shortly after the plugin is created.
+    */
+    void initState(uint32_t index, State& state) override
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(index < kStateCount,);
+
+        state.key = kStateKeys[index];
+
+        switch (index)
+        {
+        case kStateImGuiSettings:
+            // ImGui window and layout settings, kept here instead of in an imgui.ini file
+            state.hints = kStateIsOnlyForUI;
+            state.label = "ImGui Settings";
+            state.defaultValue = "";
+            break;
+        }
     }
 
     // ----------------------------------------------------------------------------------------------------------------
@@ -135,9 +606,9 @@ protected:
     */
     float getParameterValue(uint32_t index) const override
     {
-        DISTRHO_SAFE_ASSERT_RETURN(index == 0, 0.0f);
+        DISTRHO_SAFE_ASSERT_RETURN(index < kParamCount, 0.0f);
 
-        return fGainDB;
+        return fParameterMailbox.read(index);
     }
 
    /**
@@ -148,10 +619,26 @@ protected:
     */
     void setParameterValue(uint32_t index, float value) override
     {
-        DISTRHO_SAFE_ASSERT_RETURN(index == 0,);
+        DISTRHO_SAFE_ASSERT_RETURN(index < kParamCount,);
+
+        // would slip through the clamping in applyParameter(), and stay in smoothers and filter states for good
+        if (! FastMath::isFinite(value))
+        {
+            logEvent(kEventParameterNotFinite, static_cast<float>(index));
+            return;
+        }
+
+        // nothing the audio thread uses is touched here, as this may run concurrently with run()
+        fParameterMailbox.post(index, value);
+    }
 
-        fGainDB = value;
-        fSmoothGain.setTargetValue(DB_CO(CLAMP(value, -90.0, 30.0)));
+   /**
+      Change an internal state @a key to @a value.@n
+      The only state belongs to the UI, and the host stores it with the session, so there is nothing to do here.
+    */
+    void setState(const char* key, const char*) override
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(key != nullptr,);
     }
 
     // ----------------------------------------------------------------------------------------------------------------
@@ -162,7 +649,86 @@ protected:
     */
     void activate() override
     {
+        const double sampleRate = getSampleRate();
+
+        // changes made while inactive, everything below starts from them
+        applyParameterChanges();
+
+        fScratchFrames = getChunkFrames(getBufferSize());
+        fScratch.resize(getScratchSize(fScratchFrames));
+
+        const uint32_t maxDelayFrames = static_cast<uint32_t>(kMaxDelayMs * 0.001 * sampleRate) + 1;
+        fDelay.allocate(maxDelayFrames, fScratchFrames);
+        fDelayChanged = false;
+        setupDelay();
+
+        fSilent = false;
+        fSilentInputFrames = 0;
+        fSilenceHoldFrames = maxDelayFrames + DelayLine<kNumChannels>::kLatency;
+
+        // smoothers start at the current parameter values
+        fSmoothGain.setSampleRate(sampleRate);
+        fSmoothGain.setTimeConstant(0.020f); // 20ms
+        fSmoothGain.setTargetValue(DB_CO(CLAMP(fParameters[kParamGain],
+                                               kParameterRanges[kParamGain].min,
+                                               kParameterRanges[kParamGain].max)));
         fSmoothGain.clearToTargetValue();
+
+        for (uint32_t i = 0; i < kFilterParamCount; ++i)
+        {
+            const uint32_t index = kFilterParamFirst + i;
+
+            fSmoothFilter[i].setSampleRate(sampleRate / kFilterBlockSize);
+            fSmoothFilter[i].setTimeConstant(0.020f); // 20ms
+            fSmoothFilter[i].setTargetValue(CLAMP(fParameters[index],
+                                                  kParameterRanges[index].min,
+                                                  kParameterRanges[index].max));
+            fSmoothFilter[i].clearToTargetValue();
+        }
+
+        updateFilters(true);
+        fFilters.clearToTargets();
+        fFilters.clear();
+
+        fGateChanged = true;
+        fGate.reset();
+
+        fCompressorChanged = true;
+        fCompressor.reset();
+
+        fCorrelation.setup(300.0f, sampleRate);
+        fCorrelation.reset();
+
+        fMeter.allocate(fScratchFrames);
+        fMeterChanged = true;
+
+        fScopeFeed.setup(sampleRate);
+
+        fDitherChanged = true;
+        fDither.reset(kDitherSeed);
+
+        fMeterBridge.open();
+
+       #ifdef IMGUI_PLUGIN_OSC
+        startOscServer();
+       #endif
+
+        fLoggedSplit = false;
+        logEvent(kEventActivated, static_cast<float>(sampleRate), static_cast<float>(getBufferSize()));
+    }
+
+   /**
+      Deactivate this plugin.
+    */
+    void deactivate() override
+    {
+       #ifdef IMGUI_PLUGIN_OSC
+        fOscServer.stop();
+       #endif
+
+        fMeterBridge.close();
+
+        logEvent(kEventDeactivated);
     }
 
    /**
@@ -171,34 +737,780 @@ protected:
     */
     void run(const float** inputs, float** outputs, uint32_t frames) override
     {
-        // get the left and right audio inputs
-        const float* const inpL = inputs[0];
-        const float* const inpR = inputs[1];
+       #ifdef IMGUI_PLUGIN_OSC
+        // remote parameter changes, applied right away and also requested from the host where the format supports
+        // it, so the automation lane and the saved session follow; elsewhere they are transient, see OscServer
+        OscServer::Command command;
+
+        while (fOscServer.takeCommand(command))
+        {
+            setParameterValue(command.index, command.value);
+
+            if (canRequestParameterValueChanges())
+                requestParameterValueChange(command.index, command.value);
+        }
+       #endif
+
+        applyParameterChanges();
+
+        // chunking handles it, but a host going over the buffer size it announced is worth knowing about
+        const uint32_t bufferSize = getBufferSize();
+
+        if (frames > bufferSize && ! fLoggedSplit)
+        {
+            fLoggedSplit = true;
+            logEvent(kEventBlockSplit, static_cast<float>(frames), static_cast<float>(bufferSize));
+        }
 
-        // get the left and right audio outputs
-        float* const outL = outputs[0];
-        float* const outR = outputs[1];
+        // chunks are sized at activation, never above kMaxChunkFrames and only 0 when not activated yet;
+        // then there is no memory to process with, and chunks of 0 frames would never end
+        DISTRHO_SAFE_ASSERT(fScratchFrames <= kMaxChunkFrames);
 
-        // apply gain against all samples
-        for (uint32_t i=0; i < frames; ++i)
+        if (fScratchFrames == 0)
         {
-            const float gain = fSmoothGain.next();
-            outL[i] = inpL[i] * gain;
-            outR[i] = inpR[i] * gain;
+            for (uint32_t c = 0; c < kNumChannels; ++c)
+                std::memset(outputs[c], 0, sizeof(float) * frames);
+
+            return;
         }
+
+        // gain reduction outputs report the most of any chunk
+        fParameters[kParamGateReduction] = 0.0f;
+        fParameters[kParamCompReduction] = 0.0f;
+
+        for (uint32_t offset = 0; offset < frames; offset += fScratchFrames)
+            runChunk(inputs, outputs, offset, std::min(frames - offset, fScratchFrames));
+
+        if (frames != 0)
+            publishMeters(frames);
+
+        publishOutputParameters();
     }
 
     // ----------------------------------------------------------------------------------------------------------------
     // Callbacks (optional)
 
    /**
-      Optional callback to inform the plugin about a sample rate change.@n
+      Optional callback to inform the plugin about a buffer size change.@n
       This function will only be called when the plugin is deactivated.
-      @see getSampleRate()
+      @see getBufferSize()
+    */
+    void bufferSizeChanged(uint32_t newBufferSize) override
+    {
+        fScratchFrames = getChunkFrames(newBufferSize);
+        fScratch.resize(getScratchSize(fScratchFrames));
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // Internal helpers
+
+   /**
+      Frames per runChunk() call for host buffers of @a bufferSize frames, never 0.@n
+      Hosts reporting a buffer size of 0 may still send any amount of frames, so they get the largest chunks.
+    */
+    static uint32_t getChunkFrames(const uint32_t bufferSize) noexcept
+    {
+        return bufferSize != 0 ? std::min(bufferSize, kMaxChunkFrames) : kMaxChunkFrames;
+    }
+
+   /**
+      Amount of scratch memory needed to process @a frames in a single runChunk() call.@n
+      Every stage that needs intermediate buffers must account for them here.
+    */
+    static std::size_t getScratchSize(const uint32_t frames) noexcept
+    {
+        // one interleaved block with all channels, plus planar scrubbed input, planar delayed input
+        // and interleaved dither noise
+        return ScratchArena::alignedSize(frames * kNumLanes * sizeof(float))
+             + ScratchArena::alignedSize(frames * kNumChannels * sizeof(float))
+             + ScratchArena::alignedSize(frames * kNumChannels * sizeof(float))
+             + ScratchArena::alignedSize(frames * kNumLanes * sizeof(float));
+    }
+
+   /**
+      Process up to kMaxChunkFrames, or the announced buffer size if smaller, starting at @a offset in the host buffers.
+    */
+    void runChunk(const float** const inputs, float** const outputs, const uint32_t offset, const uint32_t frames)
+    {
+        // one pass over the input finds both silence and non-finite samples,
+        // the latter are not silence and get scrubbed before processing
+        const float* sources[kNumChannels];
+        bool inputSilent = true;
+        bool inputFinite = true;
+
+        for (uint32_t c = 0; c < kNumChannels; ++c)
+        {
+            bool finite;
+            sources[c] = inputs[c] + offset;
+            inputSilent = scanInput(sources[c], frames, finite) < kInputSilenceLevel && finite && inputSilent;
+            inputFinite = inputFinite && finite;
+        }
+
+        fSilentInputFrames = inputSilent ? std::min(fSilentInputFrames + frames, fSilenceHoldFrames) : 0;
+
+        if (fSilent && inputSilent)
+        {
+            runSilentChunk(outputs, offset, frames);
+            return;
+        }
+
+        if (fSilent)
+        {
+            fSilent = false;
+            logEvent(kEventSilenceEnded);
+        }
+
+        // all scratch memory from the previous chunk is free to use again
+        fScratch.reset();
+
+        float* const block = fScratch.allocate<float>(frames * kNumLanes);
+        DISTRHO_SAFE_ASSERT_RETURN(block != nullptr,);
+
+        // scrubbing, rare enough to simply go over every channel again
+        if (! inputFinite)
+        {
+            float* const scrubbed = fScratch.allocate<float>(frames * kNumChannels);
+            DISTRHO_SAFE_ASSERT_RETURN(scrubbed != nullptr,);
+
+            for (uint32_t c = 0; c < kNumChannels; ++c)
+            {
+                if (scrubNonFinite(sources[c], scrubbed + c * frames, frames) && fNonFiniteBlocks == 0)
+                    logEvent(kEventInputNotFinite, static_cast<float>(c));
+
+                sources[c] = scrubbed + c * frames;
+            }
+
+            ++fNonFiniteBlocks;
+        }
+        else if (fNonFiniteBlocks != 0)
+        {
+            logEvent(kEventInputFinite, static_cast<float>(fNonFiniteBlocks));
+            fNonFiniteBlocks = 0;
+        }
+
+        // channel alignment, on the planar host data
+        if (fDelayChanged)
+        {
+            fDelayChanged = false;
+            setupDelay();
+        }
+
+        if (fDelayEnabled)
+        {
+            float* const delayed = fScratch.allocate<float>(frames * kNumChannels);
+            DISTRHO_SAFE_ASSERT_RETURN(delayed != nullptr,);
+
+            for (uint32_t c = 0; c < kNumChannels; ++c)
+            {
+                fDelay.process(c, sources[c], delayed + c * frames, frames);
+                sources[c] = delayed + c * frames;
+            }
+
+            fDelay.advance(frames);
+        }
+
+        // interleave all channels into SIMD-friendly frames, applying polarity, padding lanes are kept silent
+        for (uint32_t i = 0; i < frames; ++i)
+        {
+            float* const frame = block + i * kNumLanes;
+
+            for (uint32_t c = 0; c < kNumChannels; ++c)
+                frame[c] = sources[c][i] * fPolarity[c];
+            for (uint32_t c = kNumChannels; c < kNumLanes; ++c)
+                frame[c] = 0.0f;
+        }
+
+        // tone shaping, with filter coefficients updated and interpolated per sub-block
+        for (uint32_t i = 0; i < frames; i += kFilterBlockSize)
+        {
+            updateFilters(false);
+
+            if (! fFilters.isIdle())
+                fFilters.process(block + i * kNumLanes, std::min(kFilterBlockSize, frames - i));
+        }
+
+        // gate / expander
+        if (fGateChanged)
+        {
+            fGateChanged = false;
+            setupGate();
+        }
+
+        if (fGate.isEnabled())
+        {
+            fGate.process(block, frames);
+            fParameters[kParamGateReduction] = std::max(fParameters[kParamGateReduction],
+                                                        fGate.takeGainReductionDB());
+        }
+
+        // compressor
+        if (fCompressorChanged)
+        {
+            fCompressorChanged = false;
+            setupCompressor();
+        }
+
+        if (fCompressor.isEnabled())
+        {
+            fCompressor.process(block, frames);
+            fParameters[kParamCompReduction] = std::max(fParameters[kParamCompReduction],
+                                                        fCompressor.takeGainReductionDB());
+        }
+
+        // dither noise for the whole block, generated in one go
+        if (fDitherChanged)
+        {
+            fDitherChanged = false;
+            setupDither();
+        }
+
+        float* noise = nullptr;
+
+        if (fDither.isEnabled())
+        {
+            noise = fScratch.allocate<float>(frames * kNumLanes);
+            DISTRHO_SAFE_ASSERT_RETURN(noise != nullptr,);
+
+            fDither.prepare(noise, frames);
+        }
+
+        // apply gain and dither against all samples, back into the host buffers,
+        // collecting the stereo meter sums from the first 2 lanes while the frame is in a register
+        Float4 cross = Float4::broadcast(0.0f);
+        Float4 energy = Float4::broadcast(0.0f);
+
+        for (uint32_t i = 0; i < frames; ++i)
+        {
+            const Float4 gain = Float4::broadcast(fSmoothGain.next());
+            float* const frame = block + i * kNumLanes;
+
+            for (uint32_t l = 0; l < kNumLanes; l += 4)
+                (Float4::load(frame + l) * gain).store(frame + l);
+
+            if (noise != nullptr)
+                fDither.processFrame(frame, noise + i * kNumLanes);
+
+            CorrelationMeter::accumulate(Float4::load(frame), cross, energy);
+
+            for (uint32_t c = 0; c < kNumChannels; ++c)
+                outputs[c][offset + i] = frame[c];
+        }
+
+        fCorrelation.integrate(cross, energy, frames);
+        fParameters[kParamCorrelation] = fCorrelation.getCorrelation();
+        fParameters[kParamBalance] = fCorrelation.getBalanceDB(kParameterRanges[kParamBalance].max);
+
+        runMeter(block, frames);
+
+        float squares[4];
+        energy.store(squares);
+        fMeterBridgeEnergy[0] += squares[0];
+        fMeterBridgeEnergy[1] += squares[1];
+
+        fScopeFeed.writeGoniometer<kNumLanes>(block, frames);
+        fScopeFeed.writeSpectrum<kNumLanes>(block, frames);
+
+        // the output only settles while dither is off, dithered silence is never below the threshold
+        if (fSilentInputFrames >= fSilenceHoldFrames)
+        {
+            bool outputSilent = true;
+
+            for (uint32_t c = 0; c < kNumChannels && outputSilent; ++c)
+                outputSilent = isSilent(outputs[c] + offset, frames, kSilenceLevel);
+
+            if (outputSilent)
+                enterSilence();
+        }
+    }
+
+   /**
+      Output silence for @a frames, keeping meters and parameter smoothing moving as if the block was processed.
+    */
+    void runSilentChunk(float** const outputs, const uint32_t offset, const uint32_t frames) noexcept
+    {
+        for (uint32_t c = 0; c < kNumChannels; ++c)
+            std::memset(outputs[c] + offset, 0, sizeof(float) * frames);
+
+        // nothing is audible, so parameter changes can land at once
+        fSmoothGain.clearToTargetValue();
+
+        for (uint32_t i = 0; i < kFilterParamCount; ++i)
+            fSmoothFilter[i].clearToTargetValue();
+
+        fCorrelation.integrate(Float4::broadcast(0.0f), Float4::broadcast(0.0f), frames);
+        fParameters[kParamCorrelation] = fCorrelation.getCorrelation();
+        fParameters[kParamBalance] = fCorrelation.getBalanceDB(kParameterRanges[kParamBalance].max);
+
+        runMeter(nullptr, frames);
+
+        // keeps the spectrogram scrolling
+        fScopeFeed.writeSpectrumSilence(frames);
+    }
+
+   /**
+      Update the output level meter with the final @a block of @a frames, or with silence if null.
+    */
+    void runMeter(const float* const block, const uint32_t frames) noexcept
+    {
+        if (fMeterChanged)
+        {
+            fMeterChanged = false;
+            setupMeter();
+        }
+
+        if (block != nullptr)
+            fMeter.process(block, frames);
+        else
+            fMeter.decay(frames);
+
+        fParameters[kParamMeterLeft] = CLAMP(fMeter.getLevelDB(0),
+                                             kParameterRanges[kParamMeterLeft].min,
+                                             kParameterRanges[kParamMeterLeft].max);
+        fParameters[kParamMeterRight] = CLAMP(fMeter.getLevelDB(1),
+                                              kParameterRanges[kParamMeterRight].min,
+                                              kParameterRanges[kParamMeterRight].max);
+    }
+
+   /**
+      Send a host block of @a frames to the meter bridge, with output levels from the energy summed over its chunks.
+    */
+    void publishMeters(const uint32_t frames) noexcept
+    {
+        const float invFrames = 1.0f / static_cast<float>(frames);
+        float values[kMeterBridgeValueCount];
+
+        values[kMeterBridgeGain] = CLAMP(fParameters[kParamGain],
+                                         kParameterRanges[kParamGain].min,
+                                         kParameterRanges[kParamGain].max);
+
+        // RMS over the block, power ratio hence half the gain conversion
+        values[kMeterBridgeLevelLeft] = 0.5f * FastMath::gainToDB(std::max(fMeterBridgeEnergy[0] * invFrames,
+                                                                            kMeterSilence));
+        values[kMeterBridgeLevelRight] = 0.5f * FastMath::gainToDB(std::max(fMeterBridgeEnergy[1] * invFrames,
+                                                                             kMeterSilence));
+        values[kMeterBridgeGateReduction] = fParameters[kParamGateReduction];
+        values[kMeterBridgeCompReduction] = fParameters[kParamCompReduction];
+        values[kMeterBridgeCorrelation] = fParameters[kParamCorrelation];
+
+        fMeterBridge.publish(values);
+
+        fMeterBridgeEnergy[0] = fMeterBridgeEnergy[1] = 0.0f;
+    }
+
+   /**
+      Switch to silent processing, dropping what is left of the stage tails so processing resumes from a clean state.
+    */
+    void enterSilence() noexcept
+    {
+        fSilent = true;
+        logEvent(kEventSilenceStarted);
+
+        if (fDelayEnabled)
+            fDelay.clear();
+
+        fFilters.clearToTargets();
+        fFilters.clear();
+        fGate.reset();
+        fCompressor.reset();
+    }
+
+   /**
+      Peak level of @a frames samples in @a data, setting @a finite to whether none of them is an infinity or a NaN.
+      The peak is meaningless when they are not.
+    */
+    static float scanInput(const float* const data, const uint32_t frames, bool& finite) noexcept
+    {
+        Float4 peak = Float4::broadcast(0.0f);
+        Float4 bad = Float4::broadcast(0.0f);
+        uint32_t i = 0;
+
+        for (; i + 4 <= frames; i += 4)
+        {
+            const Float4 samples = Float4::load(data + i);
+            peak = simd::max(peak, simd::abs(samples));
+            bad = maskOr(bad, nonFinite(samples));
+        }
+
+        float lanes[4];
+        peak.store(lanes);
+
+        float result = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+        finite = ! anyLane(bad);
+
+        for (; i < frames; ++i)
+        {
+            result = std::max(result, std::abs(data[i]));
+            finite = finite && FastMath::isFinite(data[i]);
+        }
+
+        return result;
+    }
+
+   /**
+      Copy @a frames samples from @a source to @a target, with infinities and NaNs replaced by zeros.
+      Returns true if there were any.
+    */
+    static bool scrubNonFinite(const float* const source, float* const target, const uint32_t frames) noexcept
+    {
+        const Float4 zero = Float4::broadcast(0.0f);
+        Float4 bad = zero;
+        uint32_t i = 0;
+
+        for (; i + 4 <= frames; i += 4)
+        {
+            const Float4 samples = Float4::load(source + i);
+            const Float4 mask = nonFinite(samples);
+
+            select(mask, zero, samples).store(target + i);
+            bad = maskOr(bad, mask);
+        }
+
+        bool found = anyLane(bad);
+
+        for (; i < frames; ++i)
+        {
+            const bool finite = FastMath::isFinite(source[i]);
+            target[i] = finite ? source[i] : 0.0f;
+            found = found || ! finite;
+        }
+
+        return found;
+    }
+
+   /**
+      Whether the peak level of @a frames samples in @a data is below @a level.
+    */
+    static bool isSilent(const float* const data, const uint32_t frames, const float level) noexcept
+    {
+        Float4 peak = Float4::broadcast(0.0f);
+        uint32_t i = 0;
+
+        for (; i + 4 <= frames; i += 4)
+            peak = simd::max(peak, simd::abs(Float4::load(data + i)));
+
+        float lanes[4];
+        peak.store(lanes);
+
+        float result = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+
+        for (; i < frames; ++i)
+            result = std::max(result, std::abs(data[i]));
+
+        return result < level;
+    }
+
+   #ifdef IMGUI_PLUGIN_OSC
+   /**
+      Start the OSC server on the port from the environment, on the loopback interface unless a host is given.
+    */
+    void startOscServer() noexcept
+    {
+        const char* const port = std::getenv("IMGUI_PLUGIN_OSC_PORT");
+
+        if (port == nullptr || *port == '\0')
+            return;
+
+        const char* host = std::getenv("IMGUI_PLUGIN_OSC_HOST");
+
+        if (host == nullptr || *host == '\0')
+            host = "127.0.0.1";
+
+        const uint16_t portNumber = static_cast<uint16_t>(std::atoi(port));
+
+        logEvent(fOscServer.start(host, portNumber) ? kEventOscListening : kEventOscFailed, portNumber);
+    }
+   #endif
+
+   /**
+      Add an event of this instance to the log, safe to call from the audio thread.
+    */
+    void logEvent(const EventCode code, const float arg0 = 0.0f, const float arg1 = 0.0f) noexcept
+    {
+        EventLog::getInstance().write(fLogSource, code, arg0, arg1);
+    }
+
+   /**
+      Apply the parameter changes the host posted since the last call, from the audio thread or while inactive.
+    */
+    void applyParameterChanges() noexcept
+    {
+        fParameterMailbox.collect([this](const uint32_t index, const float value) noexcept {
+            applyParameter(index, value);
+        });
+    }
+
+   /**
+      Make @a value the current value of input parameter @a index, and pass it on to the stage using it.@n
+      Stages that rebuild tables are only flagged here, they set themselves up at the start of the next chunk.
+    */
+    void applyParameter(const uint32_t index, float value) noexcept
+    {
+        fParameters[index] = value;
+        value = CLAMP(value, kParameterRanges[index].min, kParameterRanges[index].max);
+
+        switch (index)
+        {
+        case kParamGain:
+            fSmoothGain.setTargetValue(DB_CO(value));
+            break;
+        case kParamHighPassFreq:
+        case kParamLowShelfFreq:
+        case kParamLowShelfGain:
+        case kParamBellFreq:
+        case kParamBellGain:
+        case kParamBellQ:
+        case kParamHighShelfFreq:
+        case kParamHighShelfGain:
+            fSmoothFilter[index - kFilterParamFirst].setTargetValue(value);
+            break;
+        case kParamGateThreshold:
+        case kParamGateRatio:
+        case kParamGateRange:
+        case kParamGateHysteresis:
+        case kParamGateHold:
+        case kParamGateAttack:
+        case kParamGateRelease:
+            fGateChanged = true;
+            break;
+        case kParamCompThreshold:
+        case kParamCompRatio:
+        case kParamCompKnee:
+        case kParamCompAttack:
+        case kParamCompRelease:
+        case kParamCompMakeup:
+        case kParamCompLink:
+            fCompressorChanged = true;
+            break;
+        case kParamAlignment:
+        case kParamDelayLeft:
+        case kParamDelayRight:
+        case kParamPolarityLeft:
+        case kParamPolarityRight:
+            fDelayChanged = true;
+            break;
+        case kParamDither:
+        case kParamDitherShaping:
+            fDitherChanged = true;
+            break;
+        case kParamMeterMode:
+            fMeterChanged = true;
+            break;
+        }
+    }
+
+   /**
+      Make the output parameter values of the last block visible to getParameterValue() on other threads.
+    */
+    void publishOutputParameters() noexcept
+    {
+        static constexpr const uint32_t outputs[] = {
+            kParamGateReduction,
+            kParamCompReduction,
+            kParamCorrelation,
+            kParamBalance,
+            kParamMeterLeft,
+            kParamMeterRight,
+        };
+
+        for (const uint32_t index : outputs)
+            fParameterMailbox.publish(index, fParameters[index]);
+    }
+
+   /**
+      Apply the current alignment and polarity parameters.@n
+      The delay stage reports its latency for as long as its switch is on, whatever the delays are, so automating the
+      delays never changes the latency. Only flipping the switch does, which is not automatable.
+    */
+    void setupDelay() noexcept
+    {
+        for (uint32_t c = 0; c < kNumChannels; ++c)
+        {
+            const uint32_t delayParam = kParamDelayLeft + c;
+            const uint32_t polarityParam = kParamPolarityLeft + c;
+
+            fDelay.setDelay(c, CLAMP(fParameters[delayParam], 0.0f, kMaxDelayMs) * 0.001f * getSampleRate());
+            fPolarity[c] = fParameters[polarityParam] > 0.5f ? -1.0f : 1.0f;
+        }
+
+        const bool enabled = fParameters[kParamAlignment] > 0.5f;
+
+        if (enabled == fDelayEnabled)
+            return;
+
+        // start from silence rather than whatever was in the rings when last used
+        if (enabled)
+            fDelay.clear();
+
+        fDelayEnabled = enabled;
+        setLatency(enabled ? DelayLine<kNumChannels>::kLatency : 0);
+        logEvent(kEventLatencyChanged, enabled ? DelayLine<kNumChannels>::kLatency : 0);
+    }
+
+   /**
+      Apply the current dither parameters.
+    */
+    void setupDither() noexcept
+    {
+        const uint32_t dither = static_cast<uint32_t>(CLAMP(fParameters[kParamDither], 0.0f, 3.0f) + 0.5f);
+        const uint32_t shaping = static_cast<uint32_t>(CLAMP(fParameters[kParamDitherShaping], 0.0f, 3.0f) + 0.5f);
+
+        fDither.setup(kDitherBits[dither], shaping);
+    }
+
+   /**
+      Apply the current meter mode, restarting the meter from silence.
+    */
+    void setupMeter() noexcept
+    {
+        const uint32_t mode = static_cast<uint32_t>(CLAMP(fParameters[kParamMeterMode], 0.0f, 5.0f) + 0.5f);
+
+        fMeter.setup(kMeterModeBallistics[mode], getSampleRate());
+    }
+
+   /**
+      Apply the current gate parameters.
+    */
+    void setupGate() noexcept
+    {
+        const float threshold = fParameters[kParamGateThreshold];
+        const bool wasEnabled = fGate.isEnabled();
+
+        #define GATE_VALUE(p) CLAMP(fParameters[p], kParameterRanges[p].min, kParameterRanges[p].max)
+
+        fGate.setup(GATE_VALUE(kParamGateThreshold),
+                    GATE_VALUE(kParamGateRatio),
+                    GATE_VALUE(kParamGateRange),
+                    GATE_VALUE(kParamGateHysteresis),
+                    GATE_VALUE(kParamGateHold),
+                    GATE_VALUE(kParamGateAttack),
+                    GATE_VALUE(kParamGateRelease),
+                    threshold > kGateOffThreshold + 0.5f,
+                    getSampleRate());
+
+        #undef GATE_VALUE
+
+        if (fGate.isEnabled() == wasEnabled)
+            return;
+
+        // start from an open gate with fresh detector memory
+        if (fGate.isEnabled())
+            fGate.reset();
+
+        logEvent(fGate.isEnabled() ? kEventGateOn : kEventGateOff);
+    }
+
+   /**
+      Apply the current compressor parameters.
+    */
+    void setupCompressor() noexcept
+    {
+        const float ratio = fParameters[kParamCompRatio];
+        const bool wasEnabled = fCompressor.isEnabled();
+
+        #define COMP_VALUE(p) CLAMP(fParameters[p], kParameterRanges[p].min, kParameterRanges[p].max)
+
+        fCompressor.setup(COMP_VALUE(kParamCompThreshold),
+                          COMP_VALUE(kParamCompRatio),
+                          COMP_VALUE(kParamCompKnee),
+                          COMP_VALUE(kParamCompAttack),
+                          COMP_VALUE(kParamCompRelease),
+                          COMP_VALUE(kParamCompMakeup),
+                          fParameters[kParamCompLink] > 0.5f,
+                          ratio > 1.01f,
+                          getSampleRate());
+
+        #undef COMP_VALUE
+
+        if (fCompressor.isEnabled() == wasEnabled)
+            return;
+
+        // start without gain reduction and with fresh detector memory
+        if (fCompressor.isEnabled())
+            fCompressor.reset();
+
+        logEvent(fCompressor.isEnabled() ? kEventCompressorOn : kEventCompressorOff);
+    }
+
+   /**
+      Advance the filter parameter smoothers by one sub-block and redesign the filters that changed.@n
+      Trigonometry only runs while parameters are moving, an idle EQ costs a few comparisons.
     */
-    void sampleRateChanged(double newSampleRate) override
+    void updateFilters(const bool force) noexcept
     {
-        fSmoothGain.setSampleRate(newSampleRate);
+        float values[kFilterParamCount];
+        bool changed[kFilterCount] = {};
+
+        for (uint32_t i = 0; i < kFilterParamCount; ++i)
+        {
+            values[i] = fSmoothFilter[i].next();
+
+            if (force || values[i] != fFilterValues[i])
+            {
+                fFilterValues[i] = values[i];
+
+                switch (kFilterParamFirst + i)
+                {
+                case kParamHighPassFreq:
+                    changed[kFilterHighPass] = true;
+                    break;
+                case kParamLowShelfFreq:
+                case kParamLowShelfGain:
+                    changed[kFilterLowShelf] = true;
+                    break;
+                case kParamBellFreq:
+                case kParamBellGain:
+                case kParamBellQ:
+                    changed[kFilterBell] = true;
+                    break;
+                case kParamHighShelfFreq:
+                case kParamHighShelfGain:
+                    changed[kFilterHighShelf] = true;
+                    break;
+                }
+            }
+        }
+
+        const double sampleRate = getSampleRate();
+        DISTRHO_SAFE_ASSERT_RETURN(sampleRate > 0.0,);
+
+        #define FILTER_VALUE(p) values[p - kFilterParamFirst]
+
+        if (changed[kFilterHighPass])
+        {
+            const float freq = FILTER_VALUE(kParamHighPassFreq);
+            fFilters.setTarget(kFilterHighPass, freq > kHighPassOffFreq + 0.5f
+                                              ? BiquadCoefficients::highPass(freq, 0.7071f, sampleRate)
+                                              : BiquadCoefficients::identity());
+        }
+
+        if (changed[kFilterLowShelf])
+        {
+            const float gain = FILTER_VALUE(kParamLowShelfGain);
+            fFilters.setTarget(kFilterLowShelf, std::abs(gain) > 0.01f
+                                              ? BiquadCoefficients::lowShelf(FILTER_VALUE(kParamLowShelfFreq), gain,
+                                                                             sampleRate)
+                                              : BiquadCoefficients::identity());
+        }
+
+        if (changed[kFilterBell])
+        {
+            const float gain = FILTER_VALUE(kParamBellGain);
+            fFilters.setTarget(kFilterBell, std::abs(gain) > 0.01f
+                                          ? BiquadCoefficients::bell(FILTER_VALUE(kParamBellFreq), gain,
+                                                                     FILTER_VALUE(kParamBellQ), sampleRate)
+                                          : BiquadCoefficients::identity());
+        }
+
+        if (changed[kFilterHighShelf])
+        {
+            const float gain = FILTER_VALUE(kParamHighShelfGain);
+            fFilters.setTarget(kFilterHighShelf, std::abs(gain) > 0.01f
+                                               ? BiquadCoefficients::highShelf(FILTER_VALUE(kParamHighShelfFreq), gain,
+                                                                               sampleRate)
+                                               : BiquadCoefficients::identity());
+        }
+
+        #undef FILTER_VALUE
     }
 
     // ----------------------------------------------------------------------------------------------------------------
@@ -8,15 +8,102 @@
 #include "DistrhoUI.hpp"
 #include "ResizeHandle.hpp"
 
+#include "EventLog.hpp"
+#include "Goniometer.hpp"
+#include "ImGuiPluginBase.hpp"
+#include "Spectrogram.hpp"
+
+#include <deque>
+
 START_NAMESPACE_DISTRHO
 
 // --------------------------------------------------------------------------------------------------------------------
 
+// number of event log records kept by the console, older ones are dropped
+static constexpr const std::size_t kMaxLogHistory = 100000;
+
+// scale of the level meter for each kParamMeterMode value, readings arrive in dBFS and are shifted by the offset,
+// so 0 VU sits at -18 dBFS (EBU R68 alignment) and the K-system zero at its reference level
+static constexpr const struct {
+    float offset, min, max;
+    const char* format;
+} kMeterScales[] = {
+    { 0.0f, -60.0f, 0.0f, "%.1f dBFS" },  // PPM Type I
+    { 0.0f, -60.0f, 0.0f, "%.1f dBFS" },  // PPM Type II
+    { 18.0f, -20.0f, 3.0f, "%+.1f VU" },  // VU
+    { 20.0f, -40.0f, 20.0f, "%+.1f K-20" },
+    { 14.0f, -40.0f, 14.0f, "%+.1f K-14" },
+    { 12.0f, -40.0f, 12.0f, "%+.1f K-12" },
+};
+
+// collapsing sections of the editor, their open state is saved with the ImGui settings
+enum Headers {
+    kHeaderConsole = 0,
+    kHeaderAlignment,
+    kHeaderTone,
+    kHeaderGate,
+    kHeaderCompressor,
+    kHeaderMeters,
+    kHeaderGoniometer,
+    kHeaderSpectrogram,
+    kHeaderOutput,
+    kHeaderCount
+};
+
+static constexpr const struct {
+    const char* label;
+    bool defaultOpen;
+} kHeaders[kHeaderCount] = {
+    { "Console", false },
+    { "Alignment", true },
+    { "Tone", true },
+    { "Gate", true },
+    { "Compressor", true },
+    { "Meters", true },
+    { "Goniometer", false },
+    { "Spectrogram", false },
+    { "Output", true },
+};
+
+// section appended to the ImGui settings for the header states, ImGui skips sections it has no handler for
+static constexpr const char* const kHeadersSection = "[ImGuiPluginUI][Headers]\nOpen=";
+
+// --------------------------------------------------------------------------------------------------------------------
+
 class ImGuiPluginUI : public UI
 {
-    float fGain = 0.0f;
+    float fParameters[kParamCount] = {};
     ResizeHandle fResizeHandle;
 
+    // last ImGui settings sent to or received from the plugin state, received ones are applied on the next display,
+    // the only place where the ImGui context of this editor is sure to be the current one
+    String fImGuiSettings;
+    bool fImGuiSettingsPending = false;
+
+    // open state of each header as a bitmask, headers in fHeadersToApply get it forced on their next display
+    uint32_t fHeadersOpen = 0;
+    uint32_t fHeadersToApply = 0;
+    bool fHeadersChanged = false;
+
+    // event log console, records are kept as they are and only the visible lines get formatted
+    std::deque<EventRecord> fLogHistory;
+    uint64_t fLogCursor = 0;
+    uint64_t fLogLost = 0;
+    uint64_t fLogEpoch = 0;
+    bool fLogAutoScroll = true;
+
+    // records of other plugin instances in the process are left out unless asked for, 0 when the source is unknown
+    uint32_t fLogSource = 0;
+    bool fLogAllInstances = false;
+
+    // output scopes, fed by the plugin instance through direct access
+    ScopeFeed* fScopeFeed = nullptr;
+    GoniometerView fGoniometer;
+    bool fGoniometerVisible = false;
+    SpectrogramView fSpectrogram;
+    bool fSpectrogramVisible = false;
+    int fSpectrogramHistory = 10; // seconds
+
     // ----------------------------------------------------------------------------------------------------------------
 
 public:
@@ -33,6 +120,30 @@ public:
         // hide handle if UI is resizable
         if (isResizable())
             fResizeHandle.hide();
+
+        // no imgui.ini in the working directory, settings go through the plugin state instead
+        ImGui::GetIO().IniFilename = nullptr;
+
+        for (uint32_t i = 0; i < kHeaderCount; ++i)
+            if (kHeaders[i].defaultOpen)
+                fHeadersOpen |= 1u << i;
+
+        // the instance pointer is the Plugin base of the DSP side, which is an ImGuiPluginBase
+        if (void* const instance = getPluginInstancePointer())
+        {
+            ImGuiPluginBase* const plugin = static_cast<ImGuiPluginBase*>(static_cast<Plugin*>(instance));
+            fScopeFeed = &plugin->getScopeFeed();
+            fLogSource = plugin->getLogSource();
+        }
+    }
+
+    ~ImGuiPluginUI() override
+    {
+        if (fScopeFeed != nullptr)
+        {
+            fScopeFeed->setGoniometerActive(false);
+            fScopeFeed->setSpectrumActive(false);
+        }
     }
 
 protected:
@@ -45,12 +156,46 @@ protected:
     */
     void parameterChanged(uint32_t index, float value) override
     {
-        DISTRHO_SAFE_ASSERT_RETURN(index == 0,);
+        DISTRHO_SAFE_ASSERT_RETURN(index < kParamCount,);
 
-        fGain = value;
+        fParameters[index] = value;
         repaint();
     }
 
+   /**
+      A state has changed on the plugin side.@n
+      This is called by the host to inform the UI about state changes.
+    */
+    void stateChanged(const char* key, const char* value) override
+    {
+        DISTRHO_SAFE_ASSERT_RETURN(key != nullptr,);
+        DISTRHO_SAFE_ASSERT_RETURN(value != nullptr,);
+
+        if (std::strcmp(key, kStateKeys[kStateImGuiSettings]) == 0)
+        {
+            if (fImGuiSettings == value)
+                return;
+
+            // another editor's ImGui context may be current right now
+            fImGuiSettings = value;
+            fImGuiSettingsPending = true;
+            repaint();
+        }
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // UI Callbacks (optional)
+
+   /**
+      Collect new event log records, and redraw if there are any.
+    */
+    void uiIdle() override
+    {
+        // scopes animate for as long as they are shown
+        if (pollEventLog() || fGoniometerVisible || fSpectrogramVisible)
+            repaint();
+    }
+
     // ----------------------------------------------------------------------------------------------------------------
     // Widget Callbacks
 
@@ -59,6 +204,12 @@ protected:
     */
     void onImGuiDisplay() override
     {
+        if (fImGuiSettingsPending)
+        {
+            fImGuiSettingsPending = false;
+            loadImGuiSettings();
+        }
+
         const float width = getWidth();
         const float height = getHeight();
         const float margin = 20.0f * getScaleFactor();
@@ -68,23 +219,388 @@ protected:
 
         if (ImGui::Begin("Simple gain", nullptr, ImGuiWindowFlags_NoResize))
         {
-            static char aboutText[256] = "This is a demo plugin made with ImGui.\n";
-            ImGui::InputTextMultiline("About", aboutText, sizeof(aboutText));
+            if (collapsingHeader(kHeaderConsole))
+                drawConsole();
+
+            parameterSlider(kParamGain, "Gain (dB)", -90.0f, 30.0f, "%.3f");
+
+            if (collapsingHeader(kHeaderAlignment))
+            {
+                parameterCheckbox(kParamAlignment, "Enabled (adds 1 sample of latency)");
+                parameterSlider(kParamDelayLeft, "Delay L", 0.0f, 50.0f, "%.3f ms");
+                parameterSlider(kParamDelayRight, "Delay R", 0.0f, 50.0f, "%.3f ms");
+                parameterCheckbox(kParamPolarityLeft, "Invert L");
+                ImGui::SameLine();
+                parameterCheckbox(kParamPolarityRight, "Invert R");
+            }
+
+            if (collapsingHeader(kHeaderTone))
+            {
+                parameterSlider(kParamHighPassFreq, "High-pass", 10.0f, 1000.0f, "%.0f Hz", ImGuiSliderFlags_Logarithmic);
+                parameterSlider(kParamLowShelfFreq, "Low-shelf freq", 20.0f, 1000.0f, "%.0f Hz", ImGuiSliderFlags_Logarithmic);
+                parameterSlider(kParamLowShelfGain, "Low-shelf gain", -18.0f, 18.0f, "%.1f dB");
+                parameterSlider(kParamBellFreq, "Bell freq", 20.0f, 20000.0f, "%.0f Hz", ImGuiSliderFlags_Logarithmic);
+                parameterSlider(kParamBellGain, "Bell gain", -18.0f, 18.0f, "%.1f dB");
+                parameterSlider(kParamBellQ, "Bell Q", 0.1f, 10.0f, "%.2f", ImGuiSliderFlags_Logarithmic);
+                parameterSlider(kParamHighShelfFreq, "High-shelf freq", 1000.0f, 20000.0f, "%.0f Hz", ImGuiSliderFlags_Logarithmic);
+                parameterSlider(kParamHighShelfGain, "High-shelf gain", -18.0f, 18.0f, "%.1f dB");
+            }
+
+            if (collapsingHeader(kHeaderGate))
+            {
+                ImGui::PushID("Gate");
+                parameterSlider(kParamGateThreshold, "Threshold", -90.0f, 0.0f, "%.1f dB");
+                parameterSlider(kParamGateRatio, "Ratio", 1.0f, 20.0f, "1:%.1f");
+                parameterSlider(kParamGateRange, "Range", 0.0f, 90.0f, "%.1f dB");
+                parameterSlider(kParamGateHysteresis, "Hysteresis", 0.0f, 12.0f, "%.1f dB");
+                parameterSlider(kParamGateHold, "Hold", 0.0f, 500.0f, "%.0f ms");
+                parameterSlider(kParamGateAttack, "Attack", 0.1f, 50.0f, "%.1f ms", ImGuiSliderFlags_Logarithmic);
+                parameterSlider(kParamGateRelease, "Release", 5.0f, 2000.0f, "%.0f ms", ImGuiSliderFlags_Logarithmic);
+                reductionMeter(kParamGateReduction, "Reduction", 90.0f);
+                ImGui::PopID();
+            }
+
+            if (collapsingHeader(kHeaderCompressor))
+            {
+                ImGui::PushID("Compressor");
+                parameterSlider(kParamCompThreshold, "Threshold", -60.0f, 0.0f, "%.1f dB");
+                parameterSlider(kParamCompRatio, "Ratio", 1.0f, 20.0f, "%.1f:1", ImGuiSliderFlags_Logarithmic);
+                parameterSlider(kParamCompKnee, "Knee", 0.0f, 24.0f, "%.1f dB");
+                parameterSlider(kParamCompAttack, "Attack", 0.1f, 100.0f, "%.1f ms", ImGuiSliderFlags_Logarithmic);
+                parameterSlider(kParamCompRelease, "Release", 10.0f, 2000.0f, "%.0f ms", ImGuiSliderFlags_Logarithmic);
+                parameterSlider(kParamCompMakeup, "Makeup", 0.0f, 24.0f, "%.1f dB");
+                parameterCheckbox(kParamCompLink, "Stereo link");
+                reductionMeter(kParamCompReduction, "Reduction", 60.0f);
+                ImGui::PopID();
+            }
+
+            if (collapsingHeader(kHeaderMeters))
+            {
+                static const char* const meterItems[] = { "PPM Type I", "PPM Type II", "VU", "K-20", "K-14", "K-12" };
+
+                parameterCombo(kParamMeterMode, "Meter", meterItems, IM_ARRAYSIZE(meterItems));
+                levelMeter(kParamMeterLeft, "Level L");
+                levelMeter(kParamMeterRight, "Level R");
+                centeredMeter(kParamCorrelation, "Correlation", 1.0f, "%+.2f");
+                centeredMeter(kParamBalance, "Balance (R-L)", 24.0f, "%+.1f dB");
+            }
+
+            const bool goniometerVisible = fScopeFeed != nullptr && collapsingHeader(kHeaderGoniometer);
 
-            if (ImGui::SliderFloat("Gain (dB)", &fGain, -90.0f, 30.0f))
+            if (goniometerVisible != fGoniometerVisible)
             {
-                if (ImGui::IsItemActivated())
-                    editParameter(0, true);
+                fGoniometerVisible = goniometerVisible;
+                fGoniometer.clear();
+                fScopeFeed->setGoniometerActive(goniometerVisible);
+            }
 
-                setParameterValue(0, fGain);
+            if (goniometerVisible)
+            {
+                fGoniometer.update(*fScopeFeed, ImGui::GetIO().DeltaTime);
+                fGoniometer.draw(std::min(ImGui::GetContentRegionAvail().x, 256.0f * getScaleFactor()));
             }
 
-            if (ImGui::IsItemDeactivated())
+            const bool spectrogramVisible = fScopeFeed != nullptr && collapsingHeader(kHeaderSpectrogram);
+
+            if (spectrogramVisible != fSpectrogramVisible)
             {
-                editParameter(0, false);
+                fSpectrogramVisible = spectrogramVisible;
+                fSpectrogram.reset();
+                fScopeFeed->setSpectrumActive(spectrogramVisible);
+            }
+
+            if (spectrogramVisible)
+            {
+                ImGui::SliderInt("History", &fSpectrogramHistory,
+                                 SpectrogramView::kMinHistory, SpectrogramView::kMaxHistory, "%d s");
+
+                fSpectrogram.setup(getSampleRate(), fSpectrogramHistory);
+                fSpectrogram.update(*fScopeFeed);
+                fSpectrogram.draw(ImGui::GetContentRegionAvail().x, 128.0f * getScaleFactor());
+            }
+
+            if (collapsingHeader(kHeaderOutput))
+            {
+                static const char* const ditherItems[] = { "Off", "16 bit", "20 bit", "24 bit" };
+                static const char* const shapingItems[] = { "None", "1st order", "2nd order", "F-weighted" };
+
+                parameterCombo(kParamDither, "Dither", ditherItems, IM_ARRAYSIZE(ditherItems));
+                parameterCombo(kParamDitherShaping, "Noise shaping", shapingItems, IM_ARRAYSIZE(shapingItems));
             }
         }
         ImGui::End();
+
+        saveImGuiSettings();
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // Internal helpers
+
+   /**
+      Move new records from the process-wide event log into the console history,
+      keeping only those of this instance unless all instances are shown.
+      Returns true if there were any.
+    */
+    bool pollEventLog()
+    {
+        EventRecord records[256];
+        bool received = false;
+
+        while (const uint32_t count = EventLog::getInstance().read(fLogCursor, records, 256, fLogLost))
+        {
+            if (fLogEpoch == 0)
+                fLogEpoch = records[0].time;
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (fLogAllInstances || fLogSource == 0 || records[i].source == fLogSource)
+                {
+                    fLogHistory.push_back(records[i]);
+                    received = true;
+                }
+            }
+        }
+
+        if (fLogHistory.size() > kMaxLogHistory)
+        {
+            fLogLost += fLogHistory.size() - kMaxLogHistory;
+            fLogHistory.erase(fLogHistory.begin(), fLogHistory.end() - static_cast<std::ptrdiff_t>(kMaxLogHistory));
+        }
+
+        return received;
+    }
+
+   /**
+      Event log lines, with only the lines in view formatted and submitted to ImGui,
+      so the cost does not grow with the size of the history.
+    */
+    void drawConsole()
+    {
+        if (ImGui::SmallButton("Clear"))
+        {
+            fLogHistory.clear();
+            fLogLost = 0;
+        }
+
+        ImGui::SameLine();
+        ImGui::Checkbox("Auto-scroll", &fLogAutoScroll);
+
+        // records are filtered as they arrive, so the history starts over with the new filter
+        if (fLogSource != 0)
+        {
+            ImGui::SameLine();
+
+            if (ImGui::Checkbox("All instances", &fLogAllInstances))
+            {
+                fLogHistory.clear();
+                fLogLost = 0;
+            }
+        }
+
+        if (fLogLost != 0)
+        {
+            ImGui::SameLine();
+            ImGui::TextDisabled("(%llu older records lost)", static_cast<unsigned long long>(fLogLost));
+        }
+
+        const ImVec2 size(0.0f, 8.0f * ImGui::GetTextLineHeightWithSpacing());
+
+        if (ImGui::BeginChild("Console", size, true, ImGuiWindowFlags_HorizontalScrollbar))
+        {
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(fLogHistory.size()));
+
+            while (clipper.Step())
+            {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+                {
+                    const EventRecord& record(fLogHistory[static_cast<std::size_t>(i)]);
+                    char message[128];
+                    EventLog::format(record, message, sizeof(message));
+
+                    // writers on different threads may land slightly out of order, hence signed
+                    const int64_t time = static_cast<int64_t>(record.time - fLogEpoch);
+
+                    ImGui::Text("%10.3f  #%u  %s", static_cast<double>(time) * 1e-9, record.source, message);
+                }
+            }
+
+            clipper.End();
+
+            // follow new lines, unless scrolled up to read older ones
+            if (fLogAutoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
+                ImGui::SetScrollHereY(1.0f);
+        }
+        ImGui::EndChild();
+    }
+
+   /**
+      Apply the ImGui settings received from the plugin state, including the header states.
+    */
+    void loadImGuiSettings()
+    {
+        ImGui::LoadIniSettingsFromMemory(fImGuiSettings.buffer(), fImGuiSettings.length());
+
+        if (const char* const section = std::strstr(fImGuiSettings.buffer(), kHeadersSection))
+        {
+            unsigned int open = 0;
+
+            if (std::sscanf(section + std::strlen(kHeadersSection), "%u", &open) == 1)
+            {
+                fHeadersOpen = open & ((1u << kHeaderCount) - 1);
+                fHeadersToApply = (1u << kHeaderCount) - 1;
+            }
+        }
+    }
+
+   /**
+      Send the ImGui settings to the plugin state once ImGui asks for them to be saved, or a header was toggled.@n
+      ImGui rate-limits its requests, so layout changes only get saved a few seconds after they happen.
+    */
+    void saveImGuiSettings()
+    {
+        ImGuiIO& io(ImGui::GetIO());
+
+        if (! io.WantSaveIniSettings && ! fHeadersChanged)
+            return;
+
+        io.WantSaveIniSettings = false;
+        fHeadersChanged = false;
+
+        char headers[64];
+        std::snprintf(headers, sizeof(headers), "\n%s%u\n", kHeadersSection, fHeadersOpen);
+
+        String settings(ImGui::SaveIniSettingsToMemory());
+        settings += headers;
+
+        if (fImGuiSettings == settings)
+            return;
+
+        fImGuiSettings = settings;
+        setState(kStateKeys[kStateImGuiSettings], settings);
+    }
+
+   /**
+      ImGui collapsing header for @a header, keeping track of its open state for the saved settings.
+    */
+    bool collapsingHeader(const Headers header)
+    {
+        const uint32_t bit = 1u << header;
+
+        if (fHeadersToApply & bit)
+        {
+            fHeadersToApply &= ~bit;
+            ImGui::SetNextItemOpen((fHeadersOpen & bit) != 0);
+        }
+
+        const bool open = ImGui::CollapsingHeader(kHeaders[header].label,
+                                                  kHeaders[header].defaultOpen ? ImGuiTreeNodeFlags_DefaultOpen : 0);
+
+        if (open != ((fHeadersOpen & bit) != 0))
+        {
+            fHeadersOpen ^= bit;
+            fHeadersChanged = true;
+        }
+
+        return open;
+    }
+
+   /**
+      Slider bound to a plugin parameter, with host edit begin/end notifications.
+    */
+    void parameterSlider(const uint32_t index, const char* const label, const float min, const float max,
+                         const char* const format, const ImGuiSliderFlags flags = ImGuiSliderFlags_None)
+    {
+        if (ImGui::SliderFloat(label, &fParameters[index], min, max, format, flags))
+        {
+            if (ImGui::IsItemActivated())
+                editParameter(index, true);
+
+            setParameterValue(index, fParameters[index]);
+        }
+
+        if (ImGui::IsItemDeactivated())
+        {
+            editParameter(index, false);
+        }
+    }
+
+   /**
+      Checkbox bound to a boolean plugin parameter.
+    */
+    void parameterCheckbox(const uint32_t index, const char* const label)
+    {
+        bool checked = fParameters[index] > 0.5f;
+
+        if (ImGui::Checkbox(label, &checked))
+        {
+            fParameters[index] = checked ? 1.0f : 0.0f;
+
+            editParameter(index, true);
+            setParameterValue(index, fParameters[index]);
+            editParameter(index, false);
+        }
+    }
+
+   /**
+      Combo box bound to an integer plugin parameter, where each item matches one value starting from 0.
+    */
+    void parameterCombo(const uint32_t index, const char* const label, const char* const* const items, const int count)
+    {
+        int current = static_cast<int>(fParameters[index] + 0.5f);
+
+        if (ImGui::Combo(label, &current, items, count))
+        {
+            fParameters[index] = static_cast<float>(current);
+
+            editParameter(index, true);
+            setParameterValue(index, fParameters[index]);
+            editParameter(index, false);
+        }
+    }
+
+   /**
+      Bar showing a gain reduction output parameter, growing with the amount of reduction.
+    */
+    void reductionMeter(const uint32_t index, const char* const label, const float range)
+    {
+        char text[32];
+        std::snprintf(text, sizeof(text), "-%.1f dB", fParameters[index]);
+
+        ImGui::ProgressBar(fParameters[index] / range, ImVec2(ImGui::CalcItemWidth(), 0.0f), text);
+        ImGui::SameLine(0.0f, ImGui::GetStyle().ItemInnerSpacing.x);
+        ImGui::TextUnformatted(label);
+    }
+
+   /**
+      Bar showing a bipolar output parameter within +/- @a range, half full at 0.
+    */
+    void centeredMeter(const uint32_t index, const char* const label, const float range, const char* const format)
+    {
+        char text[32];
+        std::snprintf(text, sizeof(text), format, fParameters[index]);
+
+        ImGui::ProgressBar(0.5f + 0.5f * fParameters[index] / range, ImVec2(ImGui::CalcItemWidth(), 0.0f), text);
+        ImGui::SameLine(0.0f, ImGui::GetStyle().ItemInnerSpacing.x);
+        ImGui::TextUnformatted(label);
+    }
+
+   /**
+      Bar showing a level output parameter on the scale of the current meter mode.
+    */
+    void levelMeter(const uint32_t index, const char* const label)
+    {
+        const int mode = std::max(0, std::min(static_cast<int>(fParameters[kParamMeterMode] + 0.5f),
+                                              static_cast<int>(IM_ARRAYSIZE(kMeterScales)) - 1));
+        const float value = fParameters[index] + kMeterScales[mode].offset;
+
+        char text[32];
+        std::snprintf(text, sizeof(text), kMeterScales[mode].format, value);
+
+        ImGui::ProgressBar((value - kMeterScales[mode].min) / (kMeterScales[mode].max - kMeterScales[mode].min),
+                           ImVec2(ImGui::CalcItemWidth(), 0.0f), text);
+        ImGui::SameLine(0.0f, ImGui::GetStyle().ItemInnerSpacing.x);
+        ImGui::TextUnformatted(label);
     }
 
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ImGuiPluginUI)
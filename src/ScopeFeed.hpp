@@ -0,0 +1,281 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef SCOPE_FEED_HPP_INCLUDED
+#define SCOPE_FEED_HPP_INCLUDED
+
+#include "SpscQueue.hpp"
+
+#include <algorithm>
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   A pair of output samples, as plotted by the goniometer.
+ */
+struct ScopePoint {
+    float left, right;
+};
+
+/**
+   A run of consecutive mid (L+R)/2 samples, as analysed by the spectrogram.
+   Samples travel in runs so the queue is not touched once per sample.
+ */
+struct ScopeBlock {
+    static constexpr const uint32_t kSize = 64;
+    float samples[kSize];
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Output samples handed from the audio thread to the editor scopes, through lock-free queues.
+
+   The goniometer gets a fixed number of points per second whatever the sample rate, by keeping every Nth frame.
+   No filtering is needed for that: each kept pair is still an exact point of the L/R trajectory,
+   there are just fewer of them.
+   The spectrogram needs every sample, it gets the mid signal in runs of ScopeBlock::kSize samples and does all of its
+   analysis on the editor side.
+
+   The audio thread only writes while the editor says it is watching, so a closed editor costs nothing and an
+   opened one does not start from a queue full of old samples. Points and runs that do not fit are dropped.
+   The queues themselves are only allocated once the editor first watches a scope, from the editor thread,
+   so an instance that never shows one does not carry them.
+ */
+class ScopeFeed
+{
+public:
+    static constexpr const uint32_t kGoniometerRate = 12000; // points per second
+    static constexpr const uint32_t kGoniometerQueueSize = 4096;
+
+    // runs of samples, about 170 ms at 192 kHz
+    static constexpr const uint32_t kSpectrumQueueSize = 512;
+
+    ScopeFeed() noexcept
+        : fGoniometerActive(false),
+          fSpectrumActive(false),
+          fSpectrumDropped(0),
+          fGoniometer(nullptr),
+          fSpectrum(nullptr),
+          fGoniometerStep(1),
+          fGoniometerPhase(0),
+          fSpectrumFill(0) {}
+
+    ~ScopeFeed()
+    {
+        delete fGoniometer.load(std::memory_order_relaxed);
+        delete fSpectrum.load(std::memory_order_relaxed);
+    }
+
+   /**
+      Adapt the decimation to @a sampleRate, from activate().
+    */
+    void setup(const double sampleRate) noexcept
+    {
+        fGoniometerStep = std::max(1u, static_cast<uint32_t>(sampleRate / kGoniometerRate + 0.5));
+        fGoniometerPhase = 0;
+        fSpectrumFill = 0;
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // Audio thread
+
+   /**
+      Offer @a frames interleaved frames of @a kLanes samples, holding left and right in their first two lanes.
+    */
+    template <uint32_t kLanes>
+    void writeGoniometer(const float* const data, const uint32_t frames) noexcept
+    {
+        if (! fGoniometerActive.load(std::memory_order_relaxed))
+            return;
+
+        GoniometerQueue* const queue = fGoniometer.load(std::memory_order_acquire);
+
+        if (queue == nullptr)
+            return;
+
+        uint32_t i = fGoniometerPhase;
+
+        for (; i < frames; i += fGoniometerStep)
+        {
+            const ScopePoint point = { data[i * kLanes], data[i * kLanes + 1] };
+
+            if (! queue->push(point))
+                break;
+        }
+
+        // carry the decimation over to the next block, a full queue simply restarts it
+        fGoniometerPhase = i < frames ? 0 : i - frames;
+    }
+
+   /**
+      Offer @a frames interleaved frames of @a kLanes samples to the spectrogram, same layout as writeGoniometer().
+    */
+    template <uint32_t kLanes>
+    void writeSpectrum(const float* const data, const uint32_t frames) noexcept
+    {
+        if (! fSpectrumActive.load(std::memory_order_relaxed))
+            return;
+
+        for (uint32_t i = 0; i < frames; ++i)
+        {
+            fSpectrumBlock.samples[fSpectrumFill] = 0.5f * (data[i * kLanes] + data[i * kLanes + 1]);
+
+            if (++fSpectrumFill == ScopeBlock::kSize)
+            {
+                fSpectrumFill = 0;
+                pushSpectrumBlock();
+            }
+        }
+    }
+
+   /**
+      Same as writeSpectrum() with @a frames frames of silence.
+    */
+    void writeSpectrumSilence(const uint32_t frames) noexcept
+    {
+        if (! fSpectrumActive.load(std::memory_order_relaxed))
+            return;
+
+        for (uint32_t i = 0; i < frames; ++i)
+        {
+            fSpectrumBlock.samples[fSpectrumFill] = 0.0f;
+
+            if (++fSpectrumFill == ScopeBlock::kSize)
+            {
+                fSpectrumFill = 0;
+                pushSpectrumBlock();
+            }
+        }
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // Editor thread
+
+   /**
+      Start or stop receiving goniometer points, old points are dropped when starting.
+      The first start allocates the queue.
+    */
+    void setGoniometerActive(const bool active)
+    {
+        if (active == fGoniometerActive.load(std::memory_order_relaxed))
+            return;
+
+        if (active)
+        {
+            if (GoniometerQueue* const queue = fGoniometer.load(std::memory_order_relaxed))
+            {
+                ScopePoint point;
+                while (queue->pop(point)) {}
+            }
+            else
+            {
+                fGoniometer.store(new GoniometerQueue(), std::memory_order_release);
+            }
+        }
+
+        fGoniometerActive.store(active, std::memory_order_relaxed);
+    }
+
+   /**
+      Take up to @a maxCount points, returns how many were taken.
+    */
+    uint32_t readGoniometer(ScopePoint* const points, const uint32_t maxCount) noexcept
+    {
+        GoniometerQueue* const queue = fGoniometer.load(std::memory_order_relaxed);
+        uint32_t count = 0;
+
+        if (queue == nullptr)
+            return 0;
+
+        while (count < maxCount && queue->pop(points[count]))
+            ++count;
+
+        return count;
+    }
+
+   /**
+      Start or stop receiving spectrogram samples, old samples are dropped when starting.
+      The first start allocates the queue.
+    */
+    void setSpectrumActive(const bool active)
+    {
+        if (active == fSpectrumActive.load(std::memory_order_relaxed))
+            return;
+
+        if (active)
+        {
+            if (SpectrumQueue* const queue = fSpectrum.load(std::memory_order_relaxed))
+            {
+                ScopeBlock block;
+                while (queue->pop(block)) {}
+            }
+            else
+            {
+                fSpectrum.store(new SpectrumQueue(), std::memory_order_release);
+            }
+        }
+
+        fSpectrumActive.store(active, std::memory_order_relaxed);
+    }
+
+   /**
+      Take the oldest run of samples, returns false if there is none.
+    */
+    bool readSpectrum(ScopeBlock& block) noexcept
+    {
+        SpectrumQueue* const queue = fSpectrum.load(std::memory_order_relaxed);
+        return queue != nullptr && queue->pop(block);
+    }
+
+   /**
+      Number of runs dropped so far because the editor fell behind.
+    */
+    uint32_t getSpectrumDropped() const noexcept
+    {
+        return fSpectrumDropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    typedef SpscQueue<ScopePoint, kGoniometerQueueSize> GoniometerQueue;
+    typedef SpscQueue<ScopeBlock, kSpectrumQueueSize> SpectrumQueue;
+
+    void pushSpectrumBlock() noexcept
+    {
+        SpectrumQueue* const queue = fSpectrum.load(std::memory_order_acquire);
+
+        if (queue == nullptr)
+            return;
+
+        // the editor restarts its analysis when this count changes, rather than joining across the gap
+        if (! queue->push(fSpectrumBlock))
+            fSpectrumDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> fGoniometerActive;
+    std::atomic<bool> fSpectrumActive;
+    std::atomic<uint32_t> fSpectrumDropped;
+
+    // owned, set once by the editor thread, see setGoniometerActive() and setSpectrumActive()
+    std::atomic<GoniometerQueue*> fGoniometer;
+    std::atomic<SpectrumQueue*> fSpectrum;
+
+    // audio thread only
+    uint32_t fGoniometerStep, fGoniometerPhase;
+    ScopeBlock fSpectrumBlock;
+    uint32_t fSpectrumFill;
+
+    DISTRHO_DECLARE_NON_COPYABLE(ScopeFeed)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // SCOPE_FEED_HPP_INCLUDED
@@ -0,0 +1,187 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef SCRATCH_ARENA_HPP_INCLUDED
+#define SCRATCH_ARENA_HPP_INCLUDED
+
+#include "DistrhoUtils.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef DISTRHO_OS_WINDOWS
+# include <malloc.h>
+#else
+# include <sys/mman.h>
+#endif
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Preallocated scratch memory for intermediate DSP buffers.
+
+   Memory is reserved outside of the audio thread (on activate or buffer size changes),
+   then handed out in 64-byte aligned blocks through a simple bump allocator.
+   Calling reset() at the start of every run() makes all blocks available again,
+   so the audio thread never touches the heap.
+
+   Large arenas are backed by huge pages where the OS supports it, which reduces TLB pressure.
+ */
+class ScratchArena
+{
+public:
+    static constexpr const std::size_t kAlignment = 64;
+    static constexpr const std::size_t kHugePageSize = 2 * 1024 * 1024;
+
+    ScratchArena() noexcept
+        : fData(nullptr),
+          fCapacity(0),
+          fOffset(0),
+          fIsMapped(false) {}
+
+    ~ScratchArena() noexcept
+    {
+        release();
+    }
+
+   /**
+      Round @a size up to the arena alignment.
+      Useful for computing the total amount of memory to reserve.
+    */
+    static constexpr std::size_t alignedSize(const std::size_t size) noexcept
+    {
+        return (size + kAlignment - 1) & ~(kAlignment - 1);
+    }
+
+   /**
+      Reserve at least @a size bytes, reusing the current memory if it is already big enough.
+      The memory is touched right away so the audio thread does not page-fault on first use.
+      @note Not realtime-safe, must not be called from run().
+    */
+    bool resize(std::size_t size, const bool allowHugePages = true)
+    {
+        size = alignedSize(size);
+        fOffset = 0;
+
+        if (size <= fCapacity)
+            return true;
+
+        release();
+
+        if (size == 0)
+            return true;
+
+       #if defined(DISTRHO_OS_WINDOWS)
+        fData = static_cast<uint8_t*>(_aligned_malloc(size, kAlignment));
+       #else
+        if (allowHugePages && size >= kHugePageSize)
+        {
+            size = (size + kHugePageSize - 1) & ~(kHugePageSize - 1);
+
+            void* const ptr = ::mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+
+            if (ptr != MAP_FAILED)
+            {
+               #ifdef MADV_HUGEPAGE
+                ::madvise(ptr, size, MADV_HUGEPAGE);
+               #endif
+                fData = static_cast<uint8_t*>(ptr);
+                fIsMapped = true;
+            }
+        }
+
+        if (fData == nullptr)
+        {
+            void* ptr = nullptr;
+            if (::posix_memalign(&ptr, kAlignment, size) == 0)
+                fData = static_cast<uint8_t*>(ptr);
+        }
+       #endif
+
+        DISTRHO_SAFE_ASSERT_RETURN(fData != nullptr, false);
+
+        std::memset(fData, 0, size);
+        fCapacity = size;
+        return true;
+    }
+
+   /**
+      Free all reserved memory.
+      @note Not realtime-safe, must not be called from run().
+    */
+    void release() noexcept
+    {
+        if (fData == nullptr)
+            return;
+
+       #if defined(DISTRHO_OS_WINDOWS)
+        _aligned_free(fData);
+       #else
+        if (fIsMapped)
+            ::munmap(fData, fCapacity);
+        else
+            std::free(fData);
+       #endif
+
+        fData = nullptr;
+        fCapacity = 0;
+        fOffset = 0;
+        fIsMapped = false;
+    }
+
+   /**
+      Make the whole arena available again.
+      Call this once at the start of every run().
+    */
+    void reset() noexcept
+    {
+        fOffset = 0;
+    }
+
+   /**
+      Allocate an aligned block of @a count elements.
+      Returns null if the arena does not have enough space left.
+      @note Realtime-safe, memory contents are undefined.
+    */
+    template <typename T>
+    T* allocate(const std::size_t count) noexcept
+    {
+        const std::size_t size = alignedSize(count * sizeof(T));
+        DISTRHO_SAFE_ASSERT_RETURN(fOffset + size <= fCapacity, nullptr);
+
+        T* const ptr = reinterpret_cast<T*>(fData + fOffset);
+        fOffset += size;
+        return ptr;
+    }
+
+    std::size_t getCapacity() const noexcept
+    {
+        return fCapacity;
+    }
+
+    std::size_t getUsedSize() const noexcept
+    {
+        return fOffset;
+    }
+
+private:
+    uint8_t* fData;
+    std::size_t fCapacity;
+    std::size_t fOffset;
+    bool fIsMapped;
+
+    DISTRHO_DECLARE_NON_COPYABLE(ScratchArena)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // SCRATCH_ARENA_HPP_INCLUDED
@@ -0,0 +1,362 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef SIMD_HPP_INCLUDED
+#define SIMD_HPP_INCLUDED
+
+#include "FastMath.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define SIMD_USE_SSE2 1
+# include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# define SIMD_USE_NEON 1
+# include <arm_neon.h>
+#endif
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   A group of 4 floats, mapped to SSE2 or NEON registers when available and to plain arrays otherwise.
+
+   Multichannel DSP code processes channels in groups of 4 lanes, which is why channel counts get padded to a
+   multiple of 4 (see kNumLanes in PluginDSP.cpp).
+   Comparisons return lane masks for use with select(), so per-lane decisions never branch.
+   Functions named like a scalar one (min, max, abs, round, exp2, log2) are in the nested simd namespace.
+   simd::exp2() and simd::log2() use the same polynomials as their FastMath counterparts and have the same error bounds.
+ */
+struct Float4 {
+   #if defined(SIMD_USE_SSE2)
+    __m128 v;
+   #elif defined(SIMD_USE_NEON)
+    float32x4_t v;
+   #else
+    float v[4];
+   #endif
+
+    static inline Float4 load(const float* const ptr) noexcept
+    {
+       #if defined(SIMD_USE_SSE2)
+        return { _mm_loadu_ps(ptr) };
+       #elif defined(SIMD_USE_NEON)
+        return { vld1q_f32(ptr) };
+       #else
+        return { { ptr[0], ptr[1], ptr[2], ptr[3] } };
+       #endif
+    }
+
+    static inline Float4 broadcast(const float value) noexcept
+    {
+       #if defined(SIMD_USE_SSE2)
+        return { _mm_set1_ps(value) };
+       #elif defined(SIMD_USE_NEON)
+        return { vdupq_n_f32(value) };
+       #else
+        return { { value, value, value, value } };
+       #endif
+    }
+
+    inline void store(float* const ptr) const noexcept
+    {
+       #if defined(SIMD_USE_SSE2)
+        _mm_storeu_ps(ptr, v);
+       #elif defined(SIMD_USE_NEON)
+        vst1q_f32(ptr, v);
+       #else
+        ptr[0] = v[0]; ptr[1] = v[1]; ptr[2] = v[2]; ptr[3] = v[3];
+       #endif
+    }
+};
+
+#if defined(SIMD_USE_SSE2)
+# define SIMD_BINARY_OP(name, sse, neon, expr) \
+    static inline Float4 name(const Float4 a, const Float4 b) noexcept { return { sse(a.v, b.v) }; }
+#elif defined(SIMD_USE_NEON)
+# define SIMD_BINARY_OP(name, sse, neon, expr) \
+    static inline Float4 name(const Float4 a, const Float4 b) noexcept { return { neon(a.v, b.v) }; }
+#else
+# define SIMD_BINARY_OP(name, sse, neon, expr)                         \
+    static inline Float4 name(const Float4 a, const Float4 b) noexcept \
+    {                                                                  \
+        Float4 r;                                                      \
+        for (int i = 0; i < 4; ++i)                                    \
+            r.v[i] = expr(a.v[i], b.v[i]);                             \
+        return r;                                                      \
+    }
+#endif
+
+#define SIMD_EXPR_ADD(a, b) ((a) + (b))
+#define SIMD_EXPR_SUB(a, b) ((a) - (b))
+#define SIMD_EXPR_MUL(a, b) ((a) * (b))
+#define SIMD_EXPR_MIN(a, b) std::min(a, b)
+#define SIMD_EXPR_MAX(a, b) std::max(a, b)
+
+SIMD_BINARY_OP(operator+, _mm_add_ps, vaddq_f32, SIMD_EXPR_ADD)
+SIMD_BINARY_OP(operator-, _mm_sub_ps, vsubq_f32, SIMD_EXPR_SUB)
+SIMD_BINARY_OP(operator*, _mm_mul_ps, vmulq_f32, SIMD_EXPR_MUL)
+
+static inline Float4 operator/(const Float4 a, const Float4 b) noexcept
+{
+   #if defined(SIMD_USE_SSE2)
+    return { _mm_div_ps(a.v, b.v) };
+   #elif defined(SIMD_USE_NEON) && defined(__aarch64__)
+    return { vdivq_f32(a.v, b.v) };
+   #elif defined(SIMD_USE_NEON)
+    // armv7 has no vector division, refine the reciprocal estimate twice
+    float32x4_t r = vrecpeq_f32(b.v);
+    r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+    r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+    return { vmulq_f32(a.v, r) };
+   #else
+    return { { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] } };
+   #endif
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// named like their scalar counterparts, so kept out of DISTRHO_NAMESPACE where they would hide ::abs(), ::round() etc
+
+namespace simd {
+
+SIMD_BINARY_OP(min, _mm_min_ps, vminq_f32, SIMD_EXPR_MIN)
+SIMD_BINARY_OP(max, _mm_max_ps, vmaxq_f32, SIMD_EXPR_MAX)
+
+#undef SIMD_EXPR_ADD
+#undef SIMD_EXPR_SUB
+#undef SIMD_EXPR_MUL
+#undef SIMD_EXPR_MIN
+#undef SIMD_EXPR_MAX
+#undef SIMD_BINARY_OP
+
+static inline Float4 abs(const Float4 a) noexcept
+{
+   #if defined(SIMD_USE_SSE2)
+    return { _mm_and_ps(a.v, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff))) };
+   #elif defined(SIMD_USE_NEON)
+    return { vabsq_f32(a.v) };
+   #else
+    return { { std::abs(a.v[0]), std::abs(a.v[1]), std::abs(a.v[2]), std::abs(a.v[3]) } };
+   #endif
+}
+
+/**
+   Round to the nearest integer, valid within the int32 range.
+   Zero results are always positive zero, so all implementations give the same bits.
+ */
+static inline Float4 round(const Float4 a) noexcept
+{
+   #if defined(SIMD_USE_SSE2)
+    return { _mm_cvtepi32_ps(_mm_cvtps_epi32(a.v)) };
+   #elif defined(SIMD_USE_NEON) && defined(__aarch64__)
+    return { vaddq_f32(vrndnq_f32(a.v), vdupq_n_f32(0.f)) };
+   #elif defined(SIMD_USE_NEON)
+    // armv7 only converts towards zero, add half away from zero first (so exact ties round away from zero)
+    const float32x4_t half = vbslq_f32(vcltq_f32(a.v, vdupq_n_f32(0.f)), vdupq_n_f32(-0.5f), vdupq_n_f32(0.5f));
+    return { vcvtq_f32_s32(vcvtq_s32_f32(vaddq_f32(a.v, half))) };
+   #else
+    return { { std::nearbyint(a.v[0]) + 0.f, std::nearbyint(a.v[1]) + 0.f,
+               std::nearbyint(a.v[2]) + 0.f, std::nearbyint(a.v[3]) + 0.f } };
+   #endif
+}
+
+} // namespace simd
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Swap neighbouring lanes, { a, b, c, d } becomes { b, a, d, c }.
+   Multiplying a stereo frame with its swapped self gives the L*R product in the first two lanes.
+ */
+static inline Float4 swapPairs(const Float4 a) noexcept
+{
+   #if defined(SIMD_USE_SSE2)
+    return { _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(2, 3, 0, 1)) };
+   #elif defined(SIMD_USE_NEON)
+    return { vrev64q_f32(a.v) };
+   #else
+    return { { a.v[1], a.v[0], a.v[3], a.v[2] } };
+   #endif
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// lane masks, all bits set where the comparison is true
+
+static inline Float4 greaterThan(const Float4 a, const Float4 b) noexcept
+{
+   #if defined(SIMD_USE_SSE2)
+    return { _mm_cmpgt_ps(a.v, b.v) };
+   #elif defined(SIMD_USE_NEON)
+    return { vreinterpretq_f32_u32(vcgtq_f32(a.v, b.v)) };
+   #else
+    Float4 r;
+    for (int i = 0; i < 4; ++i)
+        r.v[i] = FastMath::bitsToFloat(a.v[i] > b.v[i] ? -1 : 0);
+    return r;
+   #endif
+}
+
+static inline Float4 lessThan(const Float4 a, const Float4 b) noexcept
+{
+    return greaterThan(b, a);
+}
+
+/**
+   Per lane @a mask ? @a a : @a b.
+ */
+static inline Float4 select(const Float4 mask, const Float4 a, const Float4 b) noexcept
+{
+   #if defined(SIMD_USE_SSE2)
+    return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) };
+   #elif defined(SIMD_USE_NEON)
+    return { vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v) };
+   #else
+    Float4 r;
+    for (int i = 0; i < 4; ++i)
+        r.v[i] = FastMath::floatToBits(mask.v[i]) != 0 ? a.v[i] : b.v[i];
+    return r;
+   #endif
+}
+
+/**
+   Lanes holding an infinity or a NaN.
+   Tested on the exponent bits, so unlike comparisons this keeps working with -ffast-math.
+ */
+static inline Float4 nonFinite(const Float4 a) noexcept
+{
+   #if defined(SIMD_USE_SSE2)
+    const __m128i exponent = _mm_set1_epi32(0x7f800000);
+    return { _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_castps_si128(a.v), exponent), exponent)) };
+   #elif defined(SIMD_USE_NEON)
+    const uint32x4_t exponent = vdupq_n_u32(0x7f800000);
+    return { vreinterpretq_f32_u32(vceqq_u32(vandq_u32(vreinterpretq_u32_f32(a.v), exponent), exponent)) };
+   #else
+    Float4 r;
+    for (int i = 0; i < 4; ++i)
+        r.v[i] = FastMath::bitsToFloat((FastMath::floatToBits(a.v[i]) & 0x7f800000) == 0x7f800000 ? -1 : 0);
+    return r;
+   #endif
+}
+
+/**
+   Lanes set in either mask.
+ */
+static inline Float4 maskOr(const Float4 a, const Float4 b) noexcept
+{
+   #if defined(SIMD_USE_SSE2)
+    return { _mm_or_ps(a.v, b.v) };
+   #elif defined(SIMD_USE_NEON)
+    return { vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v))) };
+   #else
+    Float4 r;
+    for (int i = 0; i < 4; ++i)
+        r.v[i] = FastMath::bitsToFloat(FastMath::floatToBits(a.v[i]) | FastMath::floatToBits(b.v[i]));
+    return r;
+   #endif
+}
+
+/**
+   Whether any lane of @a mask is set.
+ */
+static inline bool anyLane(const Float4 mask) noexcept
+{
+   #if defined(SIMD_USE_SSE2)
+    return _mm_movemask_ps(mask.v) != 0;
+   #elif defined(SIMD_USE_NEON)
+    const uint32x2_t pairs = vorr_u32(vget_low_u32(vreinterpretq_u32_f32(mask.v)),
+                                      vget_high_u32(vreinterpretq_u32_f32(mask.v)));
+    return (vget_lane_u32(pairs, 0) | vget_lane_u32(pairs, 1)) != 0;
+   #else
+    return (FastMath::floatToBits(mask.v[0]) | FastMath::floatToBits(mask.v[1])
+          | FastMath::floatToBits(mask.v[2]) | FastMath::floatToBits(mask.v[3])) != 0;
+   #endif
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+namespace simd {
+
+/**
+   Vector version of FastMath::exp2().
+ */
+static inline Float4 exp2(Float4 x) noexcept
+{
+    x = max(Float4::broadcast(-126.f), min(Float4::broadcast(126.f), x));
+
+   #if defined(SIMD_USE_SSE2)
+    __m128i i = _mm_cvttps_epi32(x.v);
+    i = _mm_add_epi32(i, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(i), x.v))); // floor
+    const Float4 f = { _mm_sub_ps(x.v, _mm_cvtepi32_ps(i)) };
+    const Float4 scale = { _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(i, _mm_set1_epi32(127)), 23)) };
+   #elif defined(SIMD_USE_NEON)
+    int32x4_t i = vcvtq_s32_f32(x.v);
+    i = vaddq_s32(i, vreinterpretq_s32_u32(vcgtq_f32(vcvtq_f32_s32(i), x.v))); // floor
+    const Float4 f = { vsubq_f32(x.v, vcvtq_f32_s32(i)) };
+    const Float4 scale = { vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(i, vdupq_n_s32(127)), 23)) };
+   #else
+    Float4 r;
+    for (int k = 0; k < 4; ++k)
+        r.v[k] = FastMath::exp2(x.v[k]);
+    return r;
+   #endif
+
+   #if defined(SIMD_USE_SSE2) || defined(SIMD_USE_NEON)
+    const Float4 p = Float4::broadcast(1.0f) + f * (Float4::broadcast(0.693151363f)
+                                             + f * (Float4::broadcast(0.240164154f)
+                                             + f * (Float4::broadcast(0.0558004468f)
+                                             + f * (Float4::broadcast(0.00901668795f)
+                                             + f * Float4::broadcast(0.00186718273f)))));
+    return p * scale;
+   #endif
+}
+
+/**
+   Vector version of FastMath::log2(), valid for positive normal values.
+ */
+static inline Float4 log2(const Float4 x) noexcept
+{
+   #if defined(SIMD_USE_SSE2)
+    const __m128i bits = _mm_castps_si128(x.v);
+    Float4 e = { _mm_cvtepi32_ps(_mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(bits, 23), _mm_set1_epi32(0xff)),
+                                               _mm_set1_epi32(127))) };
+    Float4 m = { _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)),
+                                               _mm_set1_epi32(0x3f800000))) };
+   #elif defined(SIMD_USE_NEON)
+    const int32x4_t bits = vreinterpretq_s32_f32(x.v);
+    Float4 e = { vcvtq_f32_s32(vsubq_s32(vandq_s32(vshrq_n_s32(bits, 23), vdupq_n_s32(0xff)), vdupq_n_s32(127))) };
+    Float4 m = { vreinterpretq_f32_s32(vorrq_s32(vandq_s32(bits, vdupq_n_s32(0x007fffff)),
+                                                 vdupq_n_s32(0x3f800000))) };
+   #else
+    Float4 r;
+    for (int k = 0; k < 4; ++k)
+        r.v[k] = FastMath::log2(x.v[k]);
+    return r;
+   #endif
+
+   #if defined(SIMD_USE_SSE2) || defined(SIMD_USE_NEON)
+    const Float4 adjust = greaterThan(m, Float4::broadcast(1.41421356f));
+    m = m * select(adjust, Float4::broadcast(0.5f), Float4::broadcast(1.0f));
+    e = e + select(adjust, Float4::broadcast(1.0f), Float4::broadcast(0.0f));
+
+    const Float4 t = (m - Float4::broadcast(1.0f)) / (m + Float4::broadcast(1.0f));
+    const Float4 t2 = t * t;
+    const Float4 s = t * (Float4::broadcast(2.88539008f)
+                   + t2 * (Float4::broadcast(0.961796694f)
+                   + t2 * (Float4::broadcast(0.577078016f)
+                   + t2 * (Float4::broadcast(0.412198583f)
+                   + t2 * Float4::broadcast(0.320598979f)))));
+    return e + s;
+   #endif
+}
+
+} // namespace simd
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // SIMD_HPP_INCLUDED
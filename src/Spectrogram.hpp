@@ -0,0 +1,292 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef SPECTROGRAM_HPP_INCLUDED
+#define SPECTROGRAM_HPP_INCLUDED
+
+#include "OpenGL.hpp"
+#include "Fft.hpp"
+#include "ScopeFeed.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Scrolling spectrogram (waterfall) for the editor, time going right and frequency up on a log scale.
+
+   The history lives only on the GPU, in a texture used as a ring of columns: each new analysis frame is uploaded as a
+   single column over the oldest one, and the whole history is drawn as one image quad whose horizontal texture
+   coordinates start at the oldest column and wrap around. So the work per frame is the FFT and upload of the columns
+   that are new since the last frame, whatever the history length, and memory is bounded by kMaxHistory.
+
+   Analysis runs on the editor thread, from the samples the audio thread hands over through ScopeFeed.
+   All methods must be called from the editor thread, with its OpenGL context current.
+ */
+class SpectrogramView
+{
+public:
+    static constexpr const int kRows = 256;
+    static constexpr const float kColumnRate = 50.0f; // columns per second
+    static constexpr const int kMinHistory = 2;       // seconds
+    static constexpr const int kMaxHistory = 40;      // seconds, 2000 columns fit in every usable texture size
+
+    // displayed range, in dB relative to a full scale sine
+    static constexpr const float kFloorDB = -100.0f;
+    static constexpr const float kCeilDB = 0.0f;
+    static constexpr const float kMinFrequency = 20.0f;
+
+    SpectrogramView() noexcept
+        : fSampleRate(0.0),
+          fHistory(0),
+          fColumns(0),
+          fHead(0),
+          fHop(1),
+          fInputPos(0),
+          fInputFill(0),
+          fHopFill(0),
+          fDropped(0),
+          fTexture(0) {}
+
+    ~SpectrogramView()
+    {
+        if (fTexture != 0)
+            glDeleteTextures(1, &fTexture);
+    }
+
+   /**
+      Analyse at @a sampleRate and keep @a historySeconds of columns.
+      Does nothing if neither changed, otherwise the history restarts empty.
+    */
+    void setup(const double sampleRate, const int historySeconds)
+    {
+        const int minHistory = kMinHistory, maxHistory = kMaxHistory;
+        const int history = std::max(minHistory, std::min(maxHistory, historySeconds));
+
+        if (sampleRate == fSampleRate && history == fHistory && fTexture != 0)
+            return;
+
+        DISTRHO_SAFE_ASSERT_RETURN(sampleRate > 0.0,);
+
+        fSampleRate = sampleRate;
+        fHistory = history;
+
+        // about 23 Hz resolution at any sample rate, and a hop shorter than the window up to 192 kHz
+        const uint32_t fftSize = d_nextPowerOf2(static_cast<uint32_t>(sampleRate / 24.0));
+
+        if (fftSize != fFft.getSize())
+        {
+            fFft.setup(fftSize);
+            fInput.assign(fftSize, 0.0f);
+            fReal.resize(fftSize);
+            fImag.resize(fftSize);
+            fWindow.resize(fftSize);
+
+            for (uint32_t i = 0; i < fftSize; ++i)
+                fWindow[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * i / fftSize));
+        }
+
+        fHop = std::max(1u, static_cast<uint32_t>(sampleRate / kColumnRate + 0.5));
+
+        // FFT bins covered by each row, log spaced from kMinFrequency to nyquist
+        const double nyquist = sampleRate * 0.5;
+        const double binWidth = sampleRate / fftSize;
+
+        for (int r = 0; r <= kRows; ++r)
+        {
+            const double frequency = kMinFrequency * std::pow(nyquist / kMinFrequency, static_cast<double>(r) / kRows);
+            fRowBins[r] = std::min(fftSize / 2, static_cast<uint32_t>(frequency / binWidth + 0.5));
+        }
+
+        fColumns = static_cast<int>(history * kColumnRate);
+        reset();
+    }
+
+   /**
+      Drop the history and any partial analysis, such as when the display is opened again.
+    */
+    void reset()
+    {
+        if (fColumns == 0)
+            return;
+
+        std::fill(fInput.begin(), fInput.end(), 0.0f);
+        fInputPos = fInputFill = fHopFill = 0;
+        fHead = 0;
+
+        createTexture();
+    }
+
+   /**
+      Analyse the samples waiting in @a feed, adding one column per hop.
+    */
+    void update(ScopeFeed& feed)
+    {
+        if (fTexture == 0)
+            return;
+
+        const uint32_t mask = fFft.getSize() - 1;
+        const uint32_t dropped = feed.getSpectrumDropped();
+
+        // samples went missing, start the window over instead of analysing across the gap
+        if (dropped != fDropped)
+        {
+            fDropped = dropped;
+            fInputFill = fHopFill = 0;
+        }
+
+        ScopeBlock block;
+
+        while (feed.readSpectrum(block))
+        {
+            for (uint32_t i = 0; i < ScopeBlock::kSize; ++i)
+            {
+                fInput[fInputPos] = block.samples[i];
+                fInputPos = (fInputPos + 1) & mask;
+
+                if (fInputFill <= mask)
+                    ++fInputFill;
+
+                if (++fHopFill >= fHop && fInputFill > mask)
+                {
+                    fHopFill = 0;
+                    analyse();
+                }
+            }
+        }
+    }
+
+   /**
+      Draw the whole history, oldest on the left, as a single image of @a width by @a height pixels.
+    */
+    void draw(const float width, const float height)
+    {
+        if (fTexture == 0)
+            return;
+
+        const float start = static_cast<float>(fHead) / static_cast<float>(fColumns);
+
+        ImGui::Image(reinterpret_cast<ImTextureID>(static_cast<intptr_t>(fTexture)),
+                     ImVec2(width, height), ImVec2(start, 0.0f), ImVec2(start + 1.0f, 1.0f));
+    }
+
+private:
+   /**
+      Transform the last window of input and write it as the newest column.
+    */
+    void analyse()
+    {
+        const uint32_t size = fFft.getSize();
+        const uint32_t mask = size - 1;
+
+        // oldest sample first
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            fReal[i] = fInput[(fInputPos + i) & mask] * fWindow[i];
+            fImag[i] = 0.0f;
+        }
+
+        fFft.transform(fReal.data(), fImag.data());
+
+        // a full scale sine has a magnitude of size / 4 through the Hann window
+        const float norm = 16.0f / (static_cast<float>(size) * static_cast<float>(size));
+
+        for (int r = 0; r < kRows; ++r)
+        {
+            // rows narrower than a bin show the bin they fall in, wider rows the strongest bin
+            const uint32_t first = fRowBins[r];
+            const uint32_t last = std::max(first + 1, fRowBins[r + 1]);
+            float power = 0.0f;
+
+            for (uint32_t b = first; b < last && b <= size / 2; ++b)
+                power = std::max(power, fReal[b] * fReal[b] + fImag[b] * fImag[b]);
+
+            const float db = 10.0f * std::log10(std::max(power * norm, 1e-20f));
+
+            // highest frequency in the first texture row, which is drawn at the top
+            colorFor((db - kFloorDB) / (kCeilDB - kFloorDB), fColumn + (kRows - 1 - r) * 4);
+        }
+
+        GLint previous = 0;
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+        glBindTexture(GL_TEXTURE_2D, fTexture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, fHead, 0, 1, kRows, GL_RGBA, GL_UNSIGNED_BYTE, fColumn);
+        glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(previous));
+
+        if (++fHead == fColumns)
+            fHead = 0;
+    }
+
+   /**
+      (Re)create the ring texture, empty, with wrapping along the time axis for the single quad drawing.
+    */
+    void createTexture()
+    {
+        const std::vector<uint8_t> empty(static_cast<std::size_t>(fColumns) * kRows * 4, 0);
+
+        GLint previous = 0;
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+
+        if (fTexture == 0)
+            glGenTextures(1, &fTexture);
+
+        glBindTexture(GL_TEXTURE_2D, fTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, fColumns, kRows, 0, GL_RGBA, GL_UNSIGNED_BYTE, empty.data());
+        glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(previous));
+    }
+
+   /**
+      Dark blue to red to yellow to white, for @a level between 0 and 1.
+    */
+    static void colorFor(const float level, uint8_t* const pixel) noexcept
+    {
+        static const float stops[5][3] = {
+            { 0.0f, 0.0f, 0.05f },
+            { 0.25f, 0.0f, 0.45f },
+            { 0.85f, 0.15f, 0.2f },
+            { 1.0f, 0.8f, 0.1f },
+            { 1.0f, 1.0f, 1.0f },
+        };
+
+        const float position = std::max(0.0f, std::min(1.0f, level)) * 3.999f;
+        const int index = static_cast<int>(position);
+        const float blend = position - index;
+
+        for (int c = 0; c < 3; ++c)
+        {
+            const float value = stops[index][c] + (stops[index + 1][c] - stops[index][c]) * blend;
+            pixel[c] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+        }
+
+        pixel[3] = 255;
+    }
+
+    double fSampleRate;
+    int fHistory, fColumns, fHead;
+    uint32_t fHop;
+
+    // analysis window, as a ring of the last samples
+    Fft fFft;
+    std::vector<float> fInput, fWindow, fReal, fImag;
+    uint32_t fInputPos, fInputFill, fHopFill;
+    uint32_t fDropped;
+
+    uint32_t fRowBins[kRows + 1];
+    uint8_t fColumn[kRows * 4];
+    GLuint fTexture;
+
+    DISTRHO_DECLARE_NON_COPYABLE(SpectrogramView)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // SPECTROGRAM_HPP_INCLUDED
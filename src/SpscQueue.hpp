@@ -0,0 +1,89 @@
+/*
+ * ImGui plugin example
+ * Copyright (C) 2021 Jean Pierre Cimalando <jp-dev@inbox.ru>
+ * Copyright (C) 2021-2023 Filipe Coelho <falktx@falktx.com>
+ * SPDX-License-Identifier: ISC
+ */
+
+#ifndef SPSC_QUEUE_HPP_INCLUDED
+#define SPSC_QUEUE_HPP_INCLUDED
+
+#include "DistrhoUtils.hpp"
+
+#include <atomic>
+
+START_NAMESPACE_DISTRHO
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/**
+   Bounded lock-free queue for one producer thread and one consumer thread.
+
+   Storage is a fixed ring of @a kSize items, so neither side ever allocates or blocks,
+   and push() simply fails while the queue is full.
+ */
+template <typename T, uint32_t kSize>
+class SpscQueue
+{
+    static_assert(kSize != 0 && (kSize & (kSize - 1)) == 0, "size must be a power of 2");
+
+public:
+    SpscQueue() noexcept
+        : fHead(0),
+          fTail(0) {}
+
+   /**
+      Add @a item from the producer thread, returns false if the queue is full.
+    */
+    bool push(const T& item) noexcept
+    {
+        const uint32_t tail = fTail.load(std::memory_order_relaxed);
+
+        if (tail - fHead.load(std::memory_order_acquire) == kSize)
+            return false;
+
+        fItems[tail & (kSize - 1)] = item;
+        fTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+   /**
+      Take the oldest item from the consumer thread, returns false if the queue is empty.
+    */
+    bool pop(T& item) noexcept
+    {
+        const uint32_t head = fHead.load(std::memory_order_relaxed);
+
+        if (head == fTail.load(std::memory_order_acquire))
+            return false;
+
+        item = fItems[head & (kSize - 1)];
+        fHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+   /**
+      Drop all items, only valid while neither side is using the queue.
+    */
+    void clear() noexcept
+    {
+        fHead.store(0, std::memory_order_relaxed);
+        fTail.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    // padded onto separate cache lines, so both sides do not keep stealing each other's line
+    // (no alignas, as plugin instances come from plain operator new)
+    std::atomic<uint32_t> fHead;
+    char fPadding[64 - sizeof(std::atomic<uint32_t>)];
+    std::atomic<uint32_t> fTail;
+    T fItems[kSize];
+
+    DISTRHO_DECLARE_NON_COPYABLE(SpscQueue)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif // SPSC_QUEUE_HPP_INCLUDED
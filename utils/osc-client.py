@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+# Minimal OSC client for the plugin OSC server (built with -DIMGUI_PLUGIN_OSC=ON, run with IMGUI_PLUGIN_OSC_PORT set).
+#
+#   utils/osc-client.py PORT gain            print the current gain
+#   utils/osc-client.py PORT gain -6.5       set the gain in dB
+#   utils/osc-client.py PORT meters [RATE]   print meter bundles until interrupted
+#
+# Only uses the Python standard library, the host defaults to 127.0.0.1 and can be set with OSC_HOST.
+
+import os
+import socket
+import struct
+import sys
+
+
+def pad(data):
+    return data + b"\0" * (4 - len(data) % 4)
+
+
+def message(address, *floats):
+    return pad(address.encode()) + pad(("," + "f" * len(floats)).encode()) + b"".join(struct.pack(">f", f) for f in floats)
+
+
+def read_string(data, offset):
+    end = data.index(b"\0", offset)
+    return data[offset:end].decode(), (end + 4) & ~3
+
+
+def parse(data):
+    if data.startswith(b"#bundle\0"):
+        offset, elements = 16, []
+        while offset < len(data):
+            (size,) = struct.unpack_from(">i", data, offset)
+            elements += parse(data[offset + 4:offset + 4 + size])
+            offset += 4 + size
+        return elements
+    address, offset = read_string(data, 0)
+    types, offset = read_string(data, offset)
+    values = struct.unpack_from(">" + "f" * (len(types) - 1), data, offset)
+    return [(address, values)]
+
+
+def main():
+    if len(sys.argv) < 3 or sys.argv[2] not in ("gain", "meters"):
+        print("usage: osc-client.py PORT gain [DB] | meters [RATE]", file=sys.stderr)
+        return 2
+
+    target = (os.environ.get("OSC_HOST", "127.0.0.1"), int(sys.argv[1]))
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.settimeout(2.0)
+
+    if sys.argv[2] == "gain":
+        if len(sys.argv) > 3:
+            sock.sendto(message("/gain", float(sys.argv[3])), target)
+            return 0
+        sock.sendto(message("/gain"), target)
+        for address, values in parse(sock.recv(1024)):
+            print(address, *("%.2f" % v for v in values))
+        return 0
+
+    rate = float(sys.argv[3]) if len(sys.argv) > 3 else 20.0
+    sock.sendto(message("/meters/subscribe", rate), target)
+    try:
+        while True:
+            print("  ".join("%s %s" % (a, " ".join("%.1f" % v for v in vs)) for a, vs in parse(sock.recv(1024))))
+    except KeyboardInterrupt:
+        sock.sendto(message("/meters/unsubscribe"), target)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
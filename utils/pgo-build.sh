@@ -0,0 +1,79 @@
+#!/bin/bash
+# Profile-guided optimization build of all plugin formats.
+#
+#  1. regular Release build, timed with the training driver as the baseline
+#  2. instrumented build, DSP and UI
+#  3. training run, the UI is only covered when an X display is available (xvfb-run works)
+#  4. final build using the profile, with link-time optimization
+#  5. before/after report
+#
+# GCC stores profiles by object path, so every stage reuses the same build directory.
+#
+# usage: utils/pgo-build.sh [build-dir]
+
+set -e
+
+cd "$(dirname "${0}")/.."
+
+BUILD_DIR="${1:-build-pgo}"
+PROFILE_DIR="$(pwd)/${BUILD_DIR}/pgo-profile"
+JOBS="$(nproc 2>/dev/null || echo 4)"
+
+UI_ARG=""
+if [ -n "${DISPLAY}" ]; then
+    UI_ARG="--ui"
+else
+    echo "no DISPLAY set, only the DSP will be trained"
+fi
+
+configure() {
+    cmake -S . -B "${BUILD_DIR}" \
+        -DCMAKE_BUILD_TYPE=Release \
+        -DIMGUI_PLUGIN_BENCHMARKS=ON \
+        -DIMGUI_PLUGIN_PGO_DIR="${PROFILE_DIR}" \
+        "$@" > /dev/null
+    cmake --build "${BUILD_DIR}" -j"${JOBS}"
+}
+
+# best of 3 runs, in ns/frame
+measure() {
+    local best=""
+    for i in 1 2 3; do
+        local t
+        t="$("${BUILD_DIR}/bench/training-driver" | awk '/^dsp/ { print $2 }')"
+        if [ -z "${best}" ] || awk "BEGIN { exit !(${t} < ${best}) }"; then
+            best="${t}"
+        fi
+    done
+    echo "${best}"
+}
+
+# ---------------------------------------------------------------------------------------------------------------------
+
+echo "== baseline build"
+configure -DIMGUI_PLUGIN_PGO= -DIMGUI_PLUGIN_LTO=OFF
+BEFORE="$(measure)"
+
+echo "== instrumented build"
+rm -rf "${PROFILE_DIR}"
+configure -DIMGUI_PLUGIN_PGO=generate -DIMGUI_PLUGIN_LTO=OFF
+
+echo "== training"
+"${BUILD_DIR}/bench/training-driver" ${UI_ARG}
+
+# clang writes raw profiles which need merging, GCC uses its .gcda files directly
+if ls "${PROFILE_DIR}"/*.profraw > /dev/null 2>&1; then
+    llvm-profdata merge -output="${PROFILE_DIR}/default.profdata" "${PROFILE_DIR}"/*.profraw
+fi
+
+echo "== optimized build"
+configure -DIMGUI_PLUGIN_PGO=use -DIMGUI_PLUGIN_LTO=ON
+AFTER="$(measure)"
+
+# ---------------------------------------------------------------------------------------------------------------------
+
+echo
+echo "dsp before: ${BEFORE} ns/frame"
+echo "dsp after:  ${AFTER} ns/frame"
+awk "BEGIN { printf(\"change:     %+.1f%%\n\", (${AFTER} / ${BEFORE} - 1) * 100) }"
+echo "plugins in ${BUILD_DIR}/bin"